@@ -0,0 +1,83 @@
+#pragma once
+#include <iostream>
+
+using namespace std;
+
+// Iterator over a contiguous block of elements (used by ArrayList)
+template <class T>
+class ArrayIterator {
+private:
+    T* current;
+    T* last;    // One past the final element
+
+public:
+    // Constructor
+    ArrayIterator() : current(nullptr), last(nullptr) {}
+    ArrayIterator(T* first, T* last) : current(first), last(last) {}
+
+    // Pre-increment operator (move forward)
+    ArrayIterator& operator++() {
+        if (current != last) {
+            ++current;
+        }
+        return *this;
+    }
+
+    // Post-increment operator (move forward)
+    ArrayIterator operator++(int) {
+        ArrayIterator temp = *this;
+        ++(*this);
+        return temp;
+    }
+
+    // Pre-decrement operator (move backward)
+    ArrayIterator& operator--() {
+        --current;
+        return *this;
+    }
+
+    // Post-decrement operator (move backward)
+    ArrayIterator operator--(int) {
+        ArrayIterator temp = *this;
+        --(*this);
+        return temp;
+    }
+
+    // Equality operator
+    bool operator==(const ArrayIterator& other) const {
+        return current == other.current;
+    }
+
+    // Inequality operator
+    bool operator!=(const ArrayIterator& other) const {
+        return current != other.current;
+    }
+
+    friend ostream& operator<<(ostream& os, const ArrayIterator& it) {
+        os << *it.current;
+        return os;
+    }
+
+    // Dereference operator
+    T& operator*() const {
+        return *current;
+    }
+
+    // Arrow operator
+    T* operator->() const {
+        return current;
+    }
+
+    T* getCurrent() {
+        return current;
+    }
+
+    // Iterator Methods
+    ArrayIterator<T> begin() {
+        return ArrayIterator<T>(current, last);
+    }
+
+    ArrayIterator<T> end() {
+        return ArrayIterator<T>(last, last);
+    }
+};
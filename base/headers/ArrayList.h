@@ -0,0 +1,337 @@
+#pragma once
+#include <iostream>
+#include <initializer_list>
+#include <new>
+#include <stdexcept>
+#include <utility>
+#include "ArrayIterator.h"
+
+using namespace std;
+
+// Inline element storage for ArrayList; empty when N is 0
+template <class T, int N>
+struct InlineStorage {
+    alignas(T) unsigned char bytes[N * sizeof(T)];
+
+    T* get() { return reinterpret_cast<T*>(bytes); }
+    const T* get() const { return reinterpret_cast<const T*>(bytes); }
+};
+
+template <class T>
+struct InlineStorage<T, 0> {
+    T* get() { return nullptr; }
+    const T* get() const { return nullptr; }
+};
+
+// Contiguous, index-addressable list with the same surface as List.
+// The first N elements are stored inside the object itself, so short lists
+// never touch the heap; growing past N moves the elements to a heap buffer
+// that doubles as needed. Pointers and references to elements are invalidated
+// by any operation that grows, inserts into or removes from the list.
+template <class T, int N = 0>
+class ArrayList {
+    [[no_unique_address]] InlineStorage<T, N> inlineStorage;
+    T* items;
+    int count;
+    int capacity;
+
+    [[nodiscard]]
+    bool usesInlineStorage() const {
+        return N > 0 && items == inlineStorage.get();
+    }
+
+    static T* allocateBuffer(int slots) {
+        return static_cast<T*>(::operator new(sizeof(T) * static_cast<size_t>(slots)));
+    }
+
+    void releaseBuffer() {
+        if (!usesInlineStorage() && items != nullptr) {
+            ::operator delete(items);
+        }
+        items = inlineStorage.get();
+        capacity = N;
+    }
+
+    void destroyAll() {
+        for (int i = 0; i < count; ++i) {
+            items[i].~T();
+        }
+        count = 0;
+    }
+
+    // Move the existing elements into a buffer of newCapacity slots
+    void reallocate(int newCapacity) {
+        T* newItems = allocateBuffer(newCapacity);
+        for (int i = 0; i < count; ++i) {
+            new (newItems + i) T(std::move(items[i]));
+            items[i].~T();
+        }
+        releaseBuffer();
+        items = newItems;
+        capacity = newCapacity;
+    }
+
+    [[nodiscard]]
+    int grownCapacity() const {
+        return capacity < 4 ? 4 : capacity * 2;
+    }
+
+    // Construct a new element at the tail. When the buffer is full the new
+    // element is built in the new buffer first, so arguments that refer to
+    // an existing element stay valid.
+    template <class... Args>
+    T& constructBack(Args&&... args) {
+        if (count < capacity) {
+            new (items + count) T(std::forward<Args>(args)...);
+        }
+        else {
+            int newCapacity = grownCapacity();
+            T* newItems = allocateBuffer(newCapacity);
+            new (newItems + count) T(std::forward<Args>(args)...);
+            for (int i = 0; i < count; ++i) {
+                new (newItems + i) T(std::move(items[i]));
+                items[i].~T();
+            }
+            releaseBuffer();
+            items = newItems;
+            capacity = newCapacity;
+        }
+        return items[count++];
+    }
+
+    void copyFrom(const ArrayList& other) {
+        reserve(other.count);
+        for (int i = 0; i < other.count; ++i) {
+            new (items + i) T(other.items[i]);
+        }
+        count = other.count;
+    }
+
+    // Take other's elements, stealing its heap buffer when it has one
+    void moveFrom(ArrayList& other) {
+        if (other.usesInlineStorage() || other.items == nullptr) {
+            for (int i = 0; i < other.count; ++i) {
+                new (items + i) T(std::move(other.items[i]));
+            }
+            count = other.count;
+            other.destroyAll();
+        }
+        else {
+            items = other.items;
+            count = other.count;
+            capacity = other.capacity;
+            other.items = other.inlineStorage.get();
+            other.count = 0;
+            other.capacity = N;
+        }
+    }
+
+public:
+    ~ArrayList() {
+        destroyAll();
+        releaseBuffer();
+    }
+
+    ArrayList(): items(nullptr), count(0), capacity(N) {
+        items = inlineStorage.get();
+    }
+
+    // Initializer-list constructor
+    ArrayList(initializer_list<T> ilist): items(nullptr), count(0), capacity(N) {
+        items = inlineStorage.get();
+        reserve(static_cast<int>(ilist.size()));
+        for (const T& value : ilist) {
+            push(value);
+        }
+    }
+
+    // Copy constructor - copies every element
+    ArrayList(const ArrayList& other): items(nullptr), count(0), capacity(N) {
+        items = inlineStorage.get();
+        copyFrom(other);
+    }
+
+    // Move constructor
+    ArrayList(ArrayList&& other) noexcept: items(nullptr), count(0), capacity(N) {
+        items = inlineStorage.get();
+        moveFrom(other);
+    }
+
+    // Copy assignment operator
+    ArrayList& operator=(const ArrayList& other) {
+        if (this != &other) {
+            clear();
+            copyFrom(other);
+        }
+        return *this;
+    }
+
+    // Move assignment operator
+    ArrayList& operator=(ArrayList&& other) noexcept {
+        if (this != &other) {
+            destroyAll();
+            releaseBuffer();
+            moveFrom(other);
+        }
+        return *this;
+    }
+
+    // Destroy all elements, keeping the allocated capacity for reuse
+    void clear() {
+        destroyAll();
+    }
+
+    // Make room for at least slots elements
+    void reserve(int slots) {
+        if (slots > capacity) {
+            reallocate(slots);
+        }
+    }
+
+    [[nodiscard]]
+    bool isEmpty() const {
+        return count == 0;
+    }
+
+    // Push, aka append to tail
+    void push(const T& value) {
+        constructBack(value);
+    }
+
+    void push(T&& value) {
+        constructBack(std::move(value));
+    }
+
+    // Construct an element in place at the tail
+    template <class... Args>
+    T& emplace(Args&&... args) {
+        return constructBack(std::forward<Args>(args)...);
+    }
+
+    // Push front, insert as first element
+    void pushFront(const T& value) {
+        insertAt(0, value);
+    }
+
+    T shift() {
+        if (isEmpty()) {
+            throw out_of_range("List is empty.");
+        }
+
+        T copyValue = std::move(items[0]);
+        removeAt(0);
+        return copyValue;
+    }
+
+    T pop() {
+        if (isEmpty()) {
+            throw out_of_range("List is empty.");
+        }
+
+        T copyValue = std::move(items[count - 1]);
+        items[--count].~T();
+        return copyValue;
+    }
+
+    void insertAt(const int index, const T& value) {
+        if (index < 0 || index > count) {
+            throw out_of_range("Index out of range.");
+        }
+
+        if (index == count) {
+            push(value);
+            return;
+        }
+
+        // Copy first: value may refer to an element that is about to move
+        T inserted = value;
+        constructBack(std::move(items[count - 1]));
+        for (int i = count - 2; i > index; --i) {
+            items[i] = std::move(items[i - 1]);
+        }
+        items[index] = std::move(inserted);
+    }
+
+    void removeAt(int index) {
+        if (index < 0 || index >= count) {
+            throw out_of_range("Index out of range.");
+        }
+
+        for (int i = index; i < count - 1; ++i) {
+            items[i] = std::move(items[i + 1]);
+        }
+        items[--count].~T();
+    }
+
+    T& get(int index) {
+        if (index < 0 || index >= count) {
+            throw out_of_range("Index out of range.");
+        }
+        return items[index];
+    }
+
+    T& operator[](const int index) {
+        if (index < 0 || index >= count) {
+            throw out_of_range("Index out of range.");
+        }
+        return items[index];
+    }
+
+    const T& operator[](const int index) const {
+        if (index < 0 || index >= count) {
+            throw out_of_range("Index out of range.");
+        }
+        return items[index];
+    }
+
+    T& getFirst() {
+        return items[0];
+    }
+
+    T& getLast() {
+        return items[count - 1];
+    }
+
+    [[nodiscard]]
+    int length() const {
+        return count;
+    }
+
+    [[nodiscard]]
+    int getCapacity() const {
+        return capacity;
+    }
+
+    T* getData() {
+        return items;
+    }
+
+    const T* getData() const {
+        return items;
+    }
+
+    ArrayIterator<T> getIterator() {
+        return ArrayIterator<T>(items, items + count);
+    }
+
+    ArrayIterator<const T> getIterator() const {
+        return ArrayIterator<const T>(items, items + count);
+    }
+
+    // For range-based for loops
+    ArrayIterator<T> begin() {
+        return ArrayIterator<T>(items, items + count);
+    }
+
+    ArrayIterator<T> end() {
+        return ArrayIterator<T>(items + count, items + count);
+    }
+
+    // Const versions for const objects
+    ArrayIterator<const T> begin() const { return ArrayIterator<const T>(items, items + count); }
+    ArrayIterator<const T> end() const { return ArrayIterator<const T>(items + count, items + count); }
+};
+
+// ArrayList whose first N elements live inline, for lists that are usually short
+template <class T, int N>
+using SmallList = ArrayList<T, N>;
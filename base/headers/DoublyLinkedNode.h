@@ -1,4 +1,5 @@
 #pragma once
+#include <utility>
 
 using namespace std;
 
@@ -14,15 +15,21 @@ public:
     static Node NIL;
 
     ~DoublyLinkedNode() = default;
-    DoublyLinkedNode(): value(T()), next(&NIL), previous(&NIL) {}
-    explicit DoublyLinkedNode(T value): value(value), next(&NIL), previous(&NIL) {}
+    DoublyLinkedNode(): value(), next(&NIL), previous(&NIL) {}
+    explicit DoublyLinkedNode(const T& value): value(value), next(&NIL), previous(&NIL) {}
+    explicit DoublyLinkedNode(T&& value): value(std::move(value)), next(&NIL), previous(&NIL) {}
+
+    // Construct the value in place from constructor arguments
+    template <class... Args>
+    explicit DoublyLinkedNode(in_place_t, Args&&... args)
+        : value(std::forward<Args>(args)...), next(&NIL), previous(&NIL) {}
 
     T& getValue() {
         return value;
     }
 
     void setValue(T fValue) {
-        this->value = fValue;
+        this->value = std::move(fValue);
     }
 
     Node* getNext() const {
@@ -75,9 +82,6 @@ public:
     }
 };
 
+// Sentinel node; constructed in place so move-only element types work too
 template <class T>
-DoublyLinkedNode<T> DoublyLinkedNode<T>::NIL = [] {
-    DoublyLinkedNode nil_node;
-    // The default constructor for optional makes `value` empty (nullopt), which is what we want for a sentinel.
-    return nil_node;
-}();
+DoublyLinkedNode<T> DoublyLinkedNode<T>::NIL;
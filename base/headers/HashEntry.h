@@ -1,13 +1,18 @@
 #pragma once
+#include <cstddef>
+#include <utility>
 
 template <class K, class V>
 class HashEntry {
 public:
     K key;
     V value;
+    size_t hash;    // Cached Hasher<K> result, so rehashing and probing skip the hasher
 
-    HashEntry() : key(K()), value(V()) {}
-    HashEntry(K fKey, V fValue) : key(fKey), value(fValue) {}
+    HashEntry() : key(), value(), hash(0) {}
+    // Arguments are taken by value and moved in, so callers passing temporaries pay no copy
+    HashEntry(K fKey, V fValue, size_t fHash = 0)
+        : key(std::move(fKey)), value(std::move(fValue)), hash(fHash) {}
 
     // For a hash table, equality is defined by the key.
     bool operator==(const HashEntry<K, V>& other) const {
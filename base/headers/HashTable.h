@@ -1,116 +1,329 @@
 #pragma once
 #include "HashEntry.h"      // Our new entry class
 #include "Hasher.h"         // Our new hasher
-#include "List.h"           // List data structure
 #include <cstddef>          // For size_t
+#include <cstdint>          // For fixed-width integers
+#include <ostream>
+#include <utility>          // For std::move / std::swap
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+// Open-addressing hash table using Robin Hood linear probing.
+// Entries live in one contiguous array; a parallel array records how far each
+// entry sits from its home slot. On insert, an entry that has probed further
+// takes the slot of one that has probed less, which keeps probe sequences short
+// and lets a lookup stop as soon as it meets an entry closer to home than itself.
+// The table doubles once it is 7/8 full. Pointers returned by insert/search are
+// invalidated by any later insert that grows the table, and by remove.
+// Each entry caches its full hash: probes compare hashes before keys, and
+// growing the table re-places entries without calling the hasher again.
+// A moved-from table has no slots at all and allocates on its first insert.
+
+// Probe-length statistics, for checking how well a hasher spreads real keys
+struct HashTableStats {
+    size_t entries = 0;
+    size_t capacity = 0;
+    size_t displacedEntries = 0;   // Entries not sitting in their home slot
+    size_t hashCollisions = 0;     // Entries whose full hash equals an earlier entry's
+    int32_t maxProbeLength = 0;
+    double averageProbeLength = 0.0;
+
+    friend ostream& operator<<(ostream& os, const HashTableStats& stats) {
+        os << stats.entries << " entries / " << stats.capacity << " slots, "
+           << stats.displacedEntries << " displaced, "
+           << stats.hashCollisions << " full-hash collisions, "
+           << "avg probe " << stats.averageProbeLength << ", max probe " << stats.maxProbeLength;
+        return os;
+    }
+};
 
 template <class K, class V>
 class HashTable {
 private:
     typedef HashEntry<K, V> Entry;
-    typedef List<Entry> Bucket;
 
-    Bucket* table;       // Array of Lists (buckets)
-    size_t capacity;     // Size of the array
-    size_t currentSize;  // Total number of elements
+    static constexpr size_t MIN_CAPACITY = 16;
+    static constexpr size_t MAX_LOAD_NUMERATOR = 7;
+    static constexpr size_t MAX_LOAD_DENOMINATOR = 8;
+    static constexpr int32_t EMPTY = -1;
+
+    Entry* table;         // Contiguous slot array
+    int32_t* distances;   // Probe distance from home slot per slot (EMPTY if unused)
+    size_t capacity;      // Size of the array, a power of two (0 once moved from)
+    size_t currentSize;   // Total number of elements
+    unsigned shift;       // 64 - log2(capacity), used to map hashes to slots
 
-    // Private helper to get the array index for a key
-    size_t getIndex(const K& key) const {
-        return Hasher<K>::hash(key) % capacity;
+    template <class Q>
+    static size_t hashOf(const Q& key) {
+        return Hasher<Q>::hash(key);
+    }
+
+    // Fibonacci hashing: spreads weak hashes across a power-of-two table
+    size_t homeSlot(size_t hash) const {
+        return static_cast<size_t>((static_cast<uint64_t>(hash) * 0x9E3779B97F4A7C15ull) >> shift);
+    }
+
+    size_t nextSlot(size_t index) const {
+        return (index + 1) & (capacity - 1);
+    }
+
+    static size_t roundUpCapacity(size_t requested) {
+        size_t result = MIN_CAPACITY;
+        while (result < requested) {
+            result <<= 1;
+        }
+        return result;
+    }
+
+    static unsigned shiftFor(size_t slotCount) {
+        unsigned bits = 0;
+        while ((static_cast<size_t>(1) << bits) < slotCount) {
+            ++bits;
+        }
+        return 64 - bits;
+    }
+
+    // Allocate empty slot arrays of the given power-of-two size
+    void allocate(size_t slotCount) {
+        capacity = slotCount;
+        shift = shiftFor(slotCount);
+        table = new Entry[capacity];
+        distances = new int32_t[capacity];
+        for (size_t i = 0; i < capacity; ++i) {
+            distances[i] = EMPTY;
+        }
+    }
+
+    // Index of the slot holding key (whose hash is given), or capacity if absent.
+    // Q is K itself or a transparent lookup type (see TransparentLookup).
+    template <class Q>
+    size_t findSlot(const Q& key, size_t hash) const {
+        if (capacity == 0) {
+            return capacity;
+        }
+        size_t index = homeSlot(hash);
+        int32_t distance = 0;
+
+        // Robin Hood invariant: once a slot is closer to home than we are, the key is absent
+        while (distances[index] >= distance) {
+            if (distances[index] == distance && table[index].hash == hash && table[index].key == key) {
+                return index;
+            }
+            index = nextSlot(index);
+            ++distance;
+        }
+        return capacity;
+    }
+
+    // Place an entry known to be absent, displacing richer entries along the way.
+    // Returns the slot where the new entry landed.
+    size_t place(Entry entry) {
+        size_t index = homeSlot(entry.hash);
+        int32_t distance = 0;
+        size_t landed = capacity;
+
+        while (true) {
+            if (distances[index] == EMPTY) {
+                table[index] = std::move(entry);
+                distances[index] = distance;
+                return (landed == capacity) ? index : landed;
+            }
+
+            if (distances[index] < distance) {
+                // Steal the slot from the entry that is closer to its home
+                std::swap(table[index], entry);
+                std::swap(distances[index], distance);
+                if (landed == capacity) {
+                    landed = index;
+                }
+            }
+
+            index = nextSlot(index);
+            ++distance;
+        }
+    }
+
+    // Reallocate to newCapacity slots and re-place every entry
+    void rehash(size_t newCapacity) {
+        Entry* oldTable = table;
+        int32_t* oldDistances = distances;
+        size_t oldCapacity = capacity;
+
+        allocate(newCapacity);
+
+        for (size_t i = 0; i < oldCapacity; ++i) {
+            if (oldDistances[i] != EMPTY) {
+                place(std::move(oldTable[i]));
+            }
+        }
+
+        delete[] oldTable;
+        delete[] oldDistances;
+    }
+
+    // Grow if needed, then place an entry whose key is known to be absent
+    V* placeNew(Entry entry) {
+        if (exceedsLoad(currentSize + 1, capacity)) {
+            rehash(capacity == 0 ? MIN_CAPACITY : capacity << 1);
+        }
+
+        currentSize++;
+        size_t index = place(std::move(entry));
+        return &(table[index].value);
+    }
+
+    [[nodiscard]]
+    bool exceedsLoad(size_t elementCount, size_t slotCount) const {
+        return elementCount * MAX_LOAD_DENOMINATOR > slotCount * MAX_LOAD_NUMERATOR;
     }
 
+    // Lookup types that can probe without building a K: Hasher<Q> must hash
+    // equal keys identically to Hasher<K>, and K must compare equal to Q
+    template <class Q>
+    static constexpr bool TransparentLookup = is_same_v<K, string> && is_same_v<Q, string_view>;
+
 public:
-    // Constructor
-    explicit HashTable(size_t initialCapacity = 10) {
-        capacity = (initialCapacity > 0) ? initialCapacity : 10;
-        // Allocate array of List objects
-        table = new Bucket[capacity];
-        currentSize = 0;
+    // Constructor: initialCapacity is rounded up to a power of two
+    explicit HashTable(size_t initialCapacity = MIN_CAPACITY) : currentSize(0) {
+        allocate(roundUpCapacity(initialCapacity));
     }
 
     // Destructor
     ~HashTable() {
-        // Lists will auto-clean themselves
         delete[] table;
+        delete[] distances;
     }
 
-    // Insert a key-value pair
-    V* insert(const K& key, const V& value) {
-        size_t index = getIndex(key);
-        Bucket& bucket = table[index];
+    // The table owns its slot arrays; moving hands them over
+    HashTable(const HashTable&) = delete;
+    HashTable& operator=(const HashTable&) = delete;
 
-        auto it = bucket.getIterator();
-        auto endIt = it.end();
+    // Move constructor: takes other's slot arrays, leaving it empty with no
+    // slots (still usable, it allocates on its next insert)
+    HashTable(HashTable&& other) noexcept
+        : table(std::exchange(other.table, nullptr)),
+          distances(std::exchange(other.distances, nullptr)),
+          capacity(std::exchange(other.capacity, 0)),
+          currentSize(std::exchange(other.currentSize, 0)),
+          shift(std::exchange(other.shift, 64)) {}
 
-        while (it != endIt) {
-            if (it.getCurrent()->getValue().key == key) {
-                it.getCurrent()->getValue().value = value;
-                return &(it.getCurrent()->getValue().value);
-            }
-            ++it;
+    // Our old contents are destroyed with the temporary
+    HashTable& operator=(HashTable&& other) noexcept {
+        if (this != &other) {
+            HashTable(std::move(other)).swap(*this);
         }
+        return *this;
+    }
 
-        currentSize++;
-        bucket.push(Entry(key, value));
-        return &(bucket.getLast().value);
+    void swap(HashTable& other) noexcept {
+        std::swap(table, other.table);
+        std::swap(distances, other.distances);
+        std::swap(capacity, other.capacity);
+        std::swap(currentSize, other.currentSize);
+        std::swap(shift, other.shift);
     }
 
-    bool get(const K& key, V& value) {
-        size_t index = getIndex(key);
-        Bucket& bucket = table[index];
+    // Make room for at least count elements without further rehashing
+    void reserve(size_t count) {
+        size_t needed = capacity == 0 ? MIN_CAPACITY : capacity;
+        while (exceedsLoad(count, needed)) {
+            needed <<= 1;
+        }
+        if (needed != capacity) {
+            rehash(needed);
+        }
+    }
+
+    // Insert a key-value pair (overwrites the value of an existing key)
+    V* insert(const K& key, const V& value) {
+        size_t hash = hashOf(key);
+        size_t existing = findSlot(key, hash);
+        if (existing != capacity) {
+            table[existing].value = value;
+            return &(table[existing].value);
+        }
+        return placeNew(Entry(key, value, hash));
+    }
 
-        auto it = bucket.getIterator();
-        auto endIt = it.end();
+    V* insert(K&& key, V&& value) {
+        size_t hash = hashOf(key);
+        size_t existing = findSlot(key, hash);
+        if (existing != capacity) {
+            table[existing].value = std::move(value);
+            return &(table[existing].value);
+        }
+        return placeNew(Entry(std::move(key), std::move(value), hash));
+    }
 
-        while (it != endIt) {
-            if (it.getCurrent()->getValue().key == key) {
-                value = it.getCurrent()->getValue().value;
-                return true;
-            }
-            ++it;
+    // Construct the value in place if key is absent; an existing value is left untouched
+    template <class... Args>
+    V* emplace(K key, Args&&... args) {
+        size_t hash = hashOf(key);
+        size_t existing = findSlot(key, hash);
+        if (existing != capacity) {
+            return &(table[existing].value);
+        }
+        return placeNew(Entry(std::move(key), V(std::forward<Args>(args)...), hash));
+    }
+
+    bool get(const K& key, V& value) {
+        size_t index = findSlot(key, hashOf(key));
+        if (index == capacity) {
+            return false;
         }
-        return false;
+        value = table[index].value;
+        return true;
     }
 
     V* search(const K& key) {
-        size_t index = getIndex(key);
-        Bucket& bucket = table[index];
+        size_t index = findSlot(key, hashOf(key));
+        return (index == capacity) ? nullptr : &(table[index].value);
+    }
 
-        auto it = bucket.getIterator();
-        auto endIt = it.end();
+    const V* search(const K& key) const {
+        size_t index = findSlot(key, hashOf(key));
+        return (index == capacity) ? nullptr : &(table[index].value);
+    }
 
-        while (it != endIt) {
-            if (it.getCurrent()->getValue().key == key) {
-                return &(it.getCurrent()->getValue().value);
-            }
-            ++it;
-        }
-        return nullptr;
+    // Heterogeneous lookup, e.g. search(string_view) on a string-keyed table:
+    // probes without allocating a temporary key
+    template <class Q> requires TransparentLookup<Q>
+    V* search(const Q& key) {
+        size_t index = findSlot(key, hashOf(key));
+        return (index == capacity) ? nullptr : &(table[index].value);
+    }
+
+    template <class Q> requires TransparentLookup<Q>
+    const V* search(const Q& key) const {
+        size_t index = findSlot(key, hashOf(key));
+        return (index == capacity) ? nullptr : &(table[index].value);
     }
 
     bool remove(const K& key) {
-        size_t index = getIndex(key);
-        Bucket& bucket = table[index];
-
-        auto it = bucket.getIterator();
-        auto endIt = it.end();
-        int idx = 0;
-
-        while (it != endIt) {
-            if (it.getCurrent()->getValue().key == key) {
-                bucket.removeAt(idx);
-                currentSize--;
-                return true;
-            }
-            ++it;
-            ++idx;
+        size_t index = findSlot(key, hashOf(key));
+        if (index == capacity) {
+            return false;
+        }
+
+        // Backward-shift deletion: pull the following cluster one slot closer to home
+        size_t next = nextSlot(index);
+        while (distances[next] > 0) {
+            table[index] = std::move(table[next]);
+            distances[index] = distances[next] - 1;
+            index = next;
+            next = nextSlot(next);
         }
-        return false;
+
+        table[index] = Entry();
+        distances[index] = EMPTY;
+        currentSize--;
+        return true;
     }
 
     [[nodiscard]]
     int size() const {
-        return currentSize;
+        return static_cast<int>(currentSize);
     }
 
     [[nodiscard]]
@@ -118,9 +331,60 @@ public:
         return currentSize == 0;
     }
 
+    [[nodiscard]]
+    size_t getCapacity() const {
+        return capacity;
+    }
+
+    [[nodiscard]]
+    float loadFactor() const {
+        return capacity == 0 ? 0.0f : static_cast<float>(currentSize) / static_cast<float>(capacity);
+    }
+
+    // Probe-length and collision statistics over the current contents
+    [[nodiscard]]
+    HashTableStats getStats() const {
+        HashTableStats stats;
+        stats.entries = currentSize;
+        stats.capacity = capacity;
+
+        size_t totalProbe = 0;
+        for (size_t i = 0; i < capacity; ++i) {
+            if (distances[i] == EMPTY) {
+                continue;
+            }
+            totalProbe += static_cast<size_t>(distances[i]) + 1;
+            if (distances[i] > 0) {
+                stats.displacedEntries++;
+                // Equal hashes share a home slot, and Robin Hood keeps each home's
+                // entries in one run, so only earlier slots of that run can match
+                int32_t offset = 1;
+                size_t previous = (i + capacity - 1) & (capacity - 1);
+                while (offset <= distances[i] && distances[previous] == distances[i] - offset) {
+                    if (table[previous].hash == table[i].hash) {
+                        stats.hashCollisions++;
+                        break;
+                    }
+                    previous = (previous + capacity - 1) & (capacity - 1);
+                    ++offset;
+                }
+            }
+            if (distances[i] + 1 > stats.maxProbeLength) {
+                stats.maxProbeLength = distances[i] + 1;
+            }
+        }
+        if (currentSize > 0) {
+            stats.averageProbeLength = static_cast<double>(totalProbe) / static_cast<double>(currentSize);
+        }
+        return stats;
+    }
+
     void clear() {
         for (size_t i = 0; i < capacity; ++i) {
-            table[i].clear();
+            if (distances[i] != EMPTY) {
+                table[i] = Entry();
+                distances[i] = EMPTY;
+            }
         }
         currentSize = 0;
     }
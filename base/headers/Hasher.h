@@ -1,4 +1,11 @@
 #pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <chrono>
+#include <random>
+#include <string>
+#include <string_view>
 
 using namespace std;
 
@@ -11,41 +18,150 @@ struct Hasher {
     }
 };
 
+// Per-process seed for string hashing, drawn once on first use. Seeding keeps
+// bucket layout from being predictable across runs; nothing may persist hashes.
+inline uint64_t hashSeed() {
+    static const uint64_t seed = [] {
+        random_device device;
+        uint64_t value = (static_cast<uint64_t>(device()) << 32) ^ device();
+        value ^= static_cast<uint64_t>(chrono::steady_clock::now().time_since_epoch().count());
+        return value;
+    }();
+    return seed;
+}
+
+// wyhash-style wide-word string hash: consumes 48 bytes per step in three
+// independent lanes (16 per step for the tail), mixing with a 64x64->128
+// multiply. Much better spread than djb2 for keys sharing long prefixes.
+namespace wyhash {
+    constexpr uint64_t SECRET0 = 0xa0761d6478bd642full;
+    constexpr uint64_t SECRET1 = 0xe7037ed1a0b428dbull;
+    constexpr uint64_t SECRET2 = 0x8ebc6af09c88c6e3ull;
+    constexpr uint64_t SECRET3 = 0x589965cc75374cc3ull;
+
+    // Full 128-bit product of a and b: a receives the low half, b the high half
+    inline void multiply(uint64_t& a, uint64_t& b) {
+#if defined(__SIZEOF_INT128__)
+        __uint128_t product = static_cast<__uint128_t>(a) * b;
+        a = static_cast<uint64_t>(product);
+        b = static_cast<uint64_t>(product >> 64);
+#else
+        uint64_t aLow = a & 0xffffffffull, aHigh = a >> 32;
+        uint64_t bLow = b & 0xffffffffull, bHigh = b >> 32;
+        uint64_t lowLow = aLow * bLow, lowHigh = aLow * bHigh;
+        uint64_t highLow = aHigh * bLow, highHigh = aHigh * bHigh;
+        uint64_t middle = (lowLow >> 32) + (lowHigh & 0xffffffffull) + (highLow & 0xffffffffull);
+        a = (lowLow & 0xffffffffull) | (middle << 32);
+        b = highHigh + (lowHigh >> 32) + (highLow >> 32) + (middle >> 32);
+#endif
+    }
+
+    // Fold the 128-bit product back to 64 bits
+    inline uint64_t mix(uint64_t a, uint64_t b) {
+        multiply(a, b);
+        return a ^ b;
+    }
+
+    inline uint64_t read64(const unsigned char* p) {
+        uint64_t value;
+        memcpy(&value, p, sizeof(value));
+        return value;
+    }
+
+    inline uint64_t read32(const unsigned char* p) {
+        uint32_t value;
+        memcpy(&value, p, sizeof(value));
+        return value;
+    }
+
+    // 1-3 bytes: first, middle and last byte
+    inline uint64_t read3(const unsigned char* p, size_t length) {
+        return (static_cast<uint64_t>(p[0]) << 16) | (static_cast<uint64_t>(p[length >> 1]) << 8) | p[length - 1];
+    }
+
+    inline uint64_t hash(const void* key, size_t length, uint64_t seed) {
+        const unsigned char* p = static_cast<const unsigned char*>(key);
+        seed ^= mix(seed ^ SECRET0, SECRET1);
+        uint64_t a, b;
+
+        if (length <= 16) {
+            if (length >= 4) {
+                size_t step = (length >> 3) << 2;
+                a = (read32(p) << 32) | read32(p + step);
+                b = (read32(p + length - 4) << 32) | read32(p + length - 4 - step);
+            }
+            else if (length > 0) {
+                a = read3(p, length);
+                b = 0;
+            }
+            else {
+                a = b = 0;
+            }
+        }
+        else {
+            size_t remaining = length;
+            if (remaining > 48) {
+                uint64_t lane1 = seed, lane2 = seed;
+                do {
+                    seed = mix(read64(p) ^ SECRET1, read64(p + 8) ^ seed);
+                    lane1 = mix(read64(p + 16) ^ SECRET2, read64(p + 24) ^ lane1);
+                    lane2 = mix(read64(p + 32) ^ SECRET3, read64(p + 40) ^ lane2);
+                    p += 48;
+                    remaining -= 48;
+                } while (remaining > 48);
+                seed ^= lane1 ^ lane2;
+            }
+            while (remaining > 16) {
+                seed = mix(read64(p) ^ SECRET1, read64(p + 8) ^ seed);
+                p += 16;
+                remaining -= 16;
+            }
+            // Last 16 bytes, overlapping what was already consumed if needed
+            a = read64(p + remaining - 16);
+            b = read64(p + remaining - 8);
+        }
+
+        a ^= SECRET1;
+        b ^= seed;
+        multiply(a, b);
+        return mix(a ^ SECRET0 ^ length, b ^ SECRET1);
+    }
+}
+
+// Template specialization for string_view
+template <>
+struct Hasher<string_view> {
+    static size_t hash(string_view str) {
+        return static_cast<size_t>(wyhash::hash(str.data(), str.size(), hashSeed()));
+    }
+};
+
+// Template specialization for string: must match Hasher<string_view> so
+// string-keyed tables can be probed with a string_view
+template <>
+struct Hasher<string> {
+    static size_t hash(const string& str) {
+        return Hasher<string_view>::hash(str);
+    }
+};
+
 // Template specialization for C-style strings (const char*)
 template <>
 struct Hasher<const char*> {
-    // Simple djb2 hash algorithm
     static size_t hash(const char* str) {
-        unsigned long hash = 5381;
-        int c;
-        while ((c = *str++)) {
-            hash = ((hash << 5) + hash) + c; // hash * 33 + c
-        }
-        return static_cast<size_t>(hash);
+        return Hasher<string_view>::hash(str);
     }
 };
 
 // Template specialization for int
 template <>
 struct Hasher<int> {
-    // A simple mix function to spread bits
+    // A simple mix function to spread bits (unsigned, so the multiplies wrap)
     static size_t hash(int key) {
-        key = ((key >> 16) ^ key) * 0x45d9f3b;
-        key = ((key >> 16) ^ key) * 0x45d9f3b;
-        key = (key >> 16) ^ key;
-        return static_cast<size_t>(key);
+        uint32_t x = static_cast<uint32_t>(key);
+        x = ((x >> 16) ^ x) * 0x45d9f3bu;
+        x = ((x >> 16) ^ x) * 0x45d9f3bu;
+        x = (x >> 16) ^ x;
+        return static_cast<size_t>(x);
     }
 };
-
-// Template specialization for string
-#include <string>
-template <>
-struct Hasher<string> {
-    static size_t hash(const string& str) {
-        unsigned long hash = 5381;
-        for (char c : str) {
-            hash = ((hash << 5) + hash) + c; // hash * 33 + c
-        }
-        return static_cast<size_t>(hash);
-    }
-};
\ No newline at end of file
@@ -1,26 +1,104 @@
 #pragma once
 #include <iostream>
 #include <initializer_list>
+#include <type_traits>
+#include <utility>
 #include "DoublyLinkedNode.h"
 #include "BidirectionalIterator.h"
+#include "PoolAllocator.h"
 
 using namespace std;
 
-template <class T>
+// Nodes come from Alloc (a per-list slab pool by default)
+template <class T, class Alloc = PoolAllocator<DoublyLinkedNode<T>>>
 class List {
     typedef DoublyLinkedNode<T> Node;
     Node* head;
     Node* tail;
 
     int count;
+    Alloc allocator;
+
+    template <class... Args>
+    Node* createNode(Args&&... args) {
+        return new (allocator.allocate()) Node(in_place, std::forward<Args>(args)...);
+    }
+
+    void destroyNode(Node* node) {
+        node->~Node();
+        allocator.deallocate(node);
+    }
+
+    // Append an already-constructed node at the tail
+    void linkBack(Node* node) {
+        // If list is empty
+        if (isEmpty()) {
+            head = node;
+            tail = node;
+        }
+        else {
+            tail->append(node);
+            tail = node;
+        }
+
+        ++count;
+    }
+
+    // Prepend an already-constructed node as head
+    void linkFront(Node* node) {
+        if (!isEmpty()) {
+            head->prepend(node);
+        }
+        else {
+            tail = node;
+        }
+
+        head = node;
+
+        ++count;
+    }
+
+    // Link an already-constructed node so that it ends up at index (0 < index < count)
+    void linkAt(const int index, Node* node) {
+        Node* currentNode = get(index);
+
+        // Link this node prev to currentNode previous
+        node->setPrevious(currentNode->getPrevious());
+
+        // Link this node next to currentNode
+        node->setNext(currentNode);
+
+        // Link precursorNextNode to this new node
+        currentNode->getPrevious()->setNext(node);
+
+        // Link precursorNode next to this node
+        currentNode->setPrevious(node);
+
+        ++count;
+    }
+
+    void copyFrom(const List& other) {
+        Node* current = other.head;
+        while (current != &Node::NIL) {
+            push(current->getValue());
+            current = current->getNext();
+        }
+    }
+
+    // Take over other's nodes and their pool, leaving other empty
+    void moveFrom(List& other) {
+        head = other.head;
+        tail = other.tail;
+        count = other.count;
+        allocator = std::move(other.allocator);
+
+        other.head = &Node::NIL;
+        other.tail = &Node::NIL;
+        other.count = 0;
+    }
 public:
     ~List() {
-        BidirectionalIterator<T> it(head);
-        while (it != it.end()) {
-            Node* toDelete = it.getCurrent();
-            ++it;
-            delete toDelete;
-        }
+        clear();
     }
 
     List(): head(&Node::NIL), tail(&Node::NIL), count(0) {}
@@ -34,11 +112,12 @@ public:
 
     // Copy constructor - deep copy all nodes
     List(const List& other): head(&Node::NIL), tail(&Node::NIL), count(0) {
-        Node* current = other.head;
-        while (current != &Node::NIL) {
-            push(current->getValue());
-            current = current->getNext();
-        }
+        copyFrom(other);
+    }
+
+    // Move constructor - takes the nodes, no element is copied
+    List(List&& other) noexcept: head(&Node::NIL), tail(&Node::NIL), count(0) {
+        moveFrom(other);
     }
 
     // Copy assignment operator - deep copy all nodes
@@ -47,22 +126,37 @@ public:
             // Clear existing nodes
             clear();
             // Copy from other
-            Node* current = other.head;
-            while (current != &Node::NIL) {
-                push(current->getValue());
-                current = current->getNext();
-            }
+            copyFrom(other);
         }
         return *this;
     }
 
+    // Move assignment operator
+    List& operator=(List&& other) noexcept {
+        if (this != &other) {
+            clear();
+            moveFrom(other);
+        }
+        return *this;
+    }
+
+    // Bulk release: with a pooled allocator the slabs are freed at once, and
+    // the node walk is skipped entirely when T needs no destructor
     void clear() {
-        Node* current = head;
-        while (current != &Node::NIL) {
-            Node* toDelete = current;
-            current = current->getNext();
-            delete toDelete;
+        if constexpr (!Alloc::bulkRelease || !is_trivially_destructible_v<T>) {
+            Node* current = head;
+            while (current != &Node::NIL) {
+                Node* toDelete = current;
+                current = current->getNext();
+                if constexpr (Alloc::bulkRelease) {
+                    toDelete->~Node();
+                }
+                else {
+                    destroyNode(toDelete);
+                }
+            }
         }
+        allocator.releaseAll();
         head = &Node::NIL;
         tail = &Node::NIL;
         count = 0;
@@ -74,37 +168,37 @@ public:
     }
 
     // Push, aka append to tail
-    void push(const T value) {
-        // Create a node
-        Node* node = new Node(value);
+    void push(const T& value) {
+        linkBack(createNode(value));
+    }
 
-        // If list is empty
-        if (isEmpty()) {
-            head = node;
-            tail = node;
-        }
-        else {
-            tail->append(node);
-            tail = node;
-        }
+    void push(T&& value) {
+        linkBack(createNode(std::move(value)));
+    }
 
-        ++count;
+    // Construct an element in place at the tail
+    template <class... Args>
+    T& emplace(Args&&... args) {
+        Node* node = createNode(std::forward<Args>(args)...);
+        linkBack(node);
+        return node->getValue();
     }
 
     // Push front, append as head
-    void pushFront(const T value) {
-        Node* node = new Node(value);
-
-        if (!isEmpty()) {
-            head->prepend(node);
-        }
-        else {
-            tail = node;
-        }
+    void pushFront(const T& value) {
+        linkFront(createNode(value));
+    }
 
-        head = node;
+    void pushFront(T&& value) {
+        linkFront(createNode(std::move(value)));
+    }
 
-        ++count;
+    // Construct an element in place as head
+    template <class... Args>
+    T& emplaceFront(Args&&... args) {
+        Node* node = createNode(std::forward<Args>(args)...);
+        linkFront(node);
+        return node->getValue();
     }
 
     T shift() {
@@ -113,7 +207,7 @@ public:
         }
 
         Node* toDelete = head;
-        T copyValue = toDelete->getValue();
+        T copyValue = std::move(toDelete->getValue());
         head = head->getNext();
 
         if (head != &Node::NIL) {
@@ -123,7 +217,7 @@ public:
             tail = &Node::NIL;
         }
 
-        delete toDelete;
+        destroyNode(toDelete);
         --count;
 
         return copyValue;
@@ -135,7 +229,7 @@ public:
         }
 
         Node* toDelete = tail;
-        T copyValue = toDelete->getValue();
+        T copyValue = std::move(toDelete->getValue());
         tail = tail->getPrevious();
 
         if (tail == &Node::NIL) {
@@ -145,55 +239,41 @@ public:
             tail->setNext(&Node::NIL);
         }
 
-        delete toDelete;
+        destroyNode(toDelete);
         --count;
 
         return copyValue;
     }
 
-    void insertAt(const int index, const T value) {
+    void insertAt(const int index, const T& value) {
         if (index < 0 || index > count) {
             throw out_of_range("Index out of range.");
         }
 
         if (index == 0) {
-            pushFront(value);
+            linkFront(createNode(value));
         }
         else if (index == count) {
-            push(value);
+            linkBack(createNode(value));
         }
         else {
-            // Create node
-            Node* node = new Node(value);
-
-            // Loop 
-            int currIndex = 0;
-            BidirectionalIterator<T> it(head);
-
-            while (it != it.end()) {
-                if (currIndex == index) {
-                    // Get this node
-                    Node* currentNode = it.getCurrent();
-
-                    // Link this node prev to currentNode previous
-                    node->setPrevious(currentNode->getPrevious());
-
-                    // Link this node next to currentNode
-                    node->setNext(currentNode);
-
-                    // Link precursorNextNode to this new node
-                    currentNode->getPrevious()->setNext(node);
-
-                    // Link precursorNode next to this node 
-                    currentNode->setPrevious(node);
+            linkAt(index, createNode(value));
+        }
+    }
 
-                    ++count;
-                    return;
-                }
+    void insertAt(const int index, T&& value) {
+        if (index < 0 || index > count) {
+            throw out_of_range("Index out of range.");
+        }
 
-                ++currIndex;
-                ++it;
-            }
+        if (index == 0) {
+            linkFront(createNode(std::move(value)));
+        }
+        else if (index == count) {
+            linkBack(createNode(std::move(value)));
+        }
+        else {
+            linkAt(index, createNode(std::move(value)));
         }
     }
 
@@ -214,7 +294,7 @@ public:
         Node* toDelete = get(index); // Re-use get(index) to find the node
         toDelete->getPrevious()->setNext(toDelete->getNext());
         toDelete->getNext()->setPrevious(toDelete->getPrevious());
-        delete toDelete;
+        destroyNode(toDelete);
         --count;
     }
 
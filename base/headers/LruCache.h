@@ -0,0 +1,151 @@
+#pragma once
+#include "ArrayList.h"
+#include "HashTable.h"
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+// Hit and eviction counts, for choosing a cache budget
+struct LruStats {
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    uint64_t evictions = 0;
+    int entries = 0;
+    size_t cost = 0;       // Total cost of the resident entries
+    size_t budget = 0;
+};
+
+// Least-recently-used cache bounded by total cost (bytes, glyphs, whatever the
+// caller counts) instead of entry count. Entries live in a slot array that
+// reuses freed slots, threaded on a doubly linked recency list by index, and a
+// HashTable maps keys to slots, so get, put and each eviction are O(1).
+// put evicts from the cold end until the total fits the budget, but never the
+// entry it just stored: an entry larger than the whole budget is still cached
+// on its own. Pointers returned by get and put are invalidated by the next put.
+template <class K, class V>
+class LruCache {
+private:
+    static constexpr int32_t NONE = -1;
+
+    struct Slot {
+        K key;
+        V value;
+        size_t cost;
+        int32_t newer;   // Towards the most recently used end
+        int32_t older;
+    };
+
+    ArrayList<Slot> slots;
+    ArrayList<int32_t> freeSlots;
+    HashTable<K, int32_t> index;
+    int32_t newest;
+    int32_t oldest;
+    LruStats stats;
+
+    void unlink(int32_t slot) {
+        Slot& entry = slots[slot];
+        if (entry.newer != NONE) slots[entry.newer].older = entry.older; else newest = entry.older;
+        if (entry.older != NONE) slots[entry.older].newer = entry.newer; else oldest = entry.newer;
+    }
+
+    void linkNewest(int32_t slot) {
+        slots[slot].newer = NONE;
+        slots[slot].older = newest;
+        if (newest != NONE) slots[newest].newer = slot; else oldest = slot;
+        newest = slot;
+    }
+
+    void release(int32_t slot) {
+        unlink(slot);
+        index.remove(slots[slot].key);
+        stats.cost -= slots[slot].cost;
+        stats.entries--;
+        slots[slot].value = V();   // Free what the value owns now, not on reuse
+        freeSlots.push(slot);
+    }
+
+    void evictTo(size_t budget) {
+        while (stats.cost > budget && oldest != newest) {
+            release(oldest);
+            stats.evictions++;
+        }
+    }
+
+public:
+    explicit LruCache(size_t budget = 0) : newest(NONE), oldest(NONE) {
+        stats.budget = budget;
+    }
+
+    LruCache(const LruCache&) = delete;
+    LruCache& operator=(const LruCache&) = delete;
+
+    // Shrinking the budget evicts straight away
+    void setBudget(size_t budget) {
+        stats.budget = budget;
+        evictTo(budget);
+    }
+
+    // Look up and mark as most recently used; null on a miss
+    V* get(const K& key) {
+        int32_t* slot = index.search(key);
+        if (!slot) {
+            stats.misses++;
+            return nullptr;
+        }
+        stats.hits++;
+        if (*slot != newest) {
+            unlink(*slot);
+            linkNewest(*slot);
+        }
+        return &slots[*slot].value;
+    }
+
+    // Store (or replace) an entry as the most recently used, then evict down to the budget
+    V& put(const K& key, V value, size_t cost) {
+        if (int32_t* existing = index.search(key)) {
+            release(*existing);
+        }
+
+        int32_t slot;
+        if (!freeSlots.isEmpty()) {
+            slot = freeSlots.pop();
+            slots[slot].key = key;
+            slots[slot].value = std::move(value);
+            slots[slot].cost = cost;
+        } else {
+            slot = slots.length();
+            slots.push(Slot{key, std::move(value), cost, NONE, NONE});
+        }
+        linkNewest(slot);
+        index.insert(key, slot);
+        stats.cost += cost;
+        stats.entries++;
+
+        evictTo(stats.budget);
+        return slots[slot].value;
+    }
+
+    bool remove(const K& key) {
+        int32_t* slot = index.search(key);
+        if (!slot) {
+            return false;
+        }
+        release(*slot);
+        return true;
+    }
+
+    void clear() {
+        slots.clear();
+        freeSlots.clear();
+        index.clear();
+        newest = oldest = NONE;
+        stats.entries = 0;
+        stats.cost = 0;
+    }
+
+    [[nodiscard]] int size() const { return stats.entries; }
+    [[nodiscard]] bool isEmpty() const { return stats.entries == 0; }
+    [[nodiscard]] size_t getCost() const { return stats.cost; }
+    [[nodiscard]] size_t getBudget() const { return stats.budget; }
+    const LruStats& getStats() const { return stats; }
+};
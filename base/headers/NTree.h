@@ -1,6 +1,7 @@
 #pragma once
 #include <stdexcept>
 #include <iostream>
+#include <utility>
 
 using namespace std;
 
@@ -30,6 +31,14 @@ public:
         }
     }
 
+    // Take ownership of a temporary key without copying it
+    explicit NTree(T&& key) : key(std::move(key))
+    {
+        for (int i = 0; i < N; ++i) {
+            nodes[i] = &NIL;
+        }
+    }
+
     // Disable copy and move to avoid ambiguous ownership / double delete
     NTree(const NTree&) = delete;
     NTree& operator=(const NTree&) = delete;
@@ -0,0 +1,140 @@
+#pragma once
+#include <cstddef>
+#include <new>
+#include <utility>
+
+// Allocator policies for linked-list nodes.
+// A policy hands out raw storage for one Node at a time; the container
+// constructs and destroys the Node itself. Policies with bulkRelease set can
+// drop every node they handed out in one releaseAll() call, so a container's
+// clear() does not need to return nodes one by one.
+
+// Slab pool: nodes are carved out of slabs that double in size (4 up to 512
+// nodes), freed nodes go on an intrusive free list for reuse, and releaseAll()
+// frees every slab at once. Each container owns its own pool, so nodes never
+// outlive or cross between containers.
+template <class Node>
+class PoolAllocator {
+private:
+    union Block {
+        Block* next;
+        alignas(Node) unsigned char storage[sizeof(Node)];
+    };
+
+    struct Slab {
+        Slab* next;
+    };
+
+    static constexpr size_t FIRST_SLAB_SIZE = 4;
+    static constexpr size_t MAX_SLAB_SIZE = 512;
+    static constexpr size_t HEADER_SIZE =
+        (sizeof(Slab) + alignof(Block) - 1) / alignof(Block) * alignof(Block);
+
+    Slab* slabs;          // All slabs, newest first
+    Block* freeList;      // Returned blocks, ready for reuse
+    Block* bumpCurrent;   // Next never-used block in the newest slab
+    Block* bumpEnd;       // One past the last block in the newest slab
+    size_t nextSlabSize;
+
+    void addSlab() {
+        void* raw = ::operator new(HEADER_SIZE + nextSlabSize * sizeof(Block));
+        Slab* slab = static_cast<Slab*>(raw);
+        slab->next = slabs;
+        slabs = slab;
+
+        bumpCurrent = reinterpret_cast<Block*>(static_cast<unsigned char*>(raw) + HEADER_SIZE);
+        bumpEnd = bumpCurrent + nextSlabSize;
+
+        if (nextSlabSize < MAX_SLAB_SIZE) {
+            nextSlabSize *= 2;
+        }
+    }
+
+public:
+    static constexpr bool bulkRelease = true;
+
+    PoolAllocator()
+        : slabs(nullptr), freeList(nullptr), bumpCurrent(nullptr), bumpEnd(nullptr),
+          nextSlabSize(FIRST_SLAB_SIZE) {}
+
+    ~PoolAllocator() {
+        releaseAll();
+    }
+
+    // Each pool owns its slabs; moving transfers them
+    PoolAllocator(const PoolAllocator&) = delete;
+    PoolAllocator& operator=(const PoolAllocator&) = delete;
+
+    PoolAllocator(PoolAllocator&& other) noexcept : PoolAllocator() {
+        swap(other);
+    }
+
+    PoolAllocator& operator=(PoolAllocator&& other) noexcept {
+        if (this != &other) {
+            releaseAll();
+            swap(other);
+        }
+        return *this;
+    }
+
+    void swap(PoolAllocator& other) noexcept {
+        std::swap(slabs, other.slabs);
+        std::swap(freeList, other.freeList);
+        std::swap(bumpCurrent, other.bumpCurrent);
+        std::swap(bumpEnd, other.bumpEnd);
+        std::swap(nextSlabSize, other.nextSlabSize);
+    }
+
+    // Raw storage for one node
+    Node* allocate() {
+        Block* block;
+        if (freeList != nullptr) {
+            block = freeList;
+            freeList = freeList->next;
+        }
+        else {
+            if (bumpCurrent == bumpEnd) {
+                addSlab();
+            }
+            block = bumpCurrent++;
+        }
+        return reinterpret_cast<Node*>(block->storage);
+    }
+
+    // Return storage of a node that has already been destroyed
+    void deallocate(Node* node) {
+        Block* block = reinterpret_cast<Block*>(node);
+        block->next = freeList;
+        freeList = block;
+    }
+
+    // Free every slab at once; all outstanding nodes must already be destroyed
+    void releaseAll() {
+        while (slabs != nullptr) {
+            Slab* toDelete = slabs;
+            slabs = slabs->next;
+            ::operator delete(toDelete);
+        }
+        freeList = nullptr;
+        bumpCurrent = nullptr;
+        bumpEnd = nullptr;
+        nextSlabSize = FIRST_SLAB_SIZE;
+    }
+};
+
+// Plain heap policy: one allocation per node (the original behaviour)
+template <class Node>
+class HeapAllocator {
+public:
+    static constexpr bool bulkRelease = false;
+
+    Node* allocate() {
+        return static_cast<Node*>(::operator new(sizeof(Node)));
+    }
+
+    void deallocate(Node* node) {
+        ::operator delete(node);
+    }
+
+    void releaseAll() {}
+};
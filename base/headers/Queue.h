@@ -2,17 +2,28 @@
 #include <iostream>
 #include "SinglyLinkedList.h"
 
-template <class T>
+// Nodes come from Alloc (a per-queue slab pool by default)
+template <class T, class Alloc = PoolAllocator<SinglyLinkedNode<T>>>
 class Queue {
 private:
-    SinglyLinkedList<T> list;
+    SinglyLinkedList<T, Alloc> list;
 public:
-    Queue(): list(SinglyLinkedList<T>()) {}
+    Queue(): list() {}
 
     void enqueue(const T& value) {
         list.push(value);
     }
 
+    void enqueue(T&& value) {
+        list.push(std::move(value));
+    }
+
+    // Construct an element in place at the back
+    template <class... Args>
+    T& emplace(Args&&... args) {
+        return list.emplace(std::forward<Args>(args)...);
+    }
+
     T dequeue() {
         return list.popFront();
     }
@@ -1,10 +1,15 @@
 #pragma once
 #include "SinglyLinkedNode.h"
 #include "ForwardIterator.h"
+#include "PoolAllocator.h"
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
 
 using namespace std;
 
-template <class T>
+// Nodes come from Alloc (a per-list slab pool by default)
+template <class T, class Alloc = PoolAllocator<SinglyLinkedNode<T>>>
 class SinglyLinkedList {
 private:
     typedef SinglyLinkedNode<T> Node;
@@ -12,36 +17,20 @@ private:
     Node* head;
     Node* tail;
     int count;
+    Alloc allocator;
 
-public:
-    SinglyLinkedList() : head(&Node::NIL), tail(&Node::NIL), count(0) {}
-
-    ~SinglyLinkedList() {
-        clear();
+    template <class... Args>
+    Node* createNode(Args&&... args) {
+        return new (allocator.allocate()) Node(in_place, std::forward<Args>(args)...);
     }
 
-    SinglyLinkedList(const SinglyLinkedList& other) : head(&Node::NIL), tail(&Node::NIL), count(0) {
-        Node* current = other.head;
-        while (current != &Node::NIL) {
-            push(current->getValue());
-            current = current->getNext();
-        }
+    void destroyNode(Node* node) {
+        node->~Node();
+        allocator.deallocate(node);
     }
 
-    SinglyLinkedList& operator=(const SinglyLinkedList& other) {
-        if (this != &other) {
-            clear();
-            Node* current = other.head;
-            while (current != &Node::NIL) {
-                push(current->getValue());
-                current = current->getNext();
-            }
-        }
-        return *this;
-    }
-
-    void push(const T& value) {
-        Node* newNode = new Node(value);
+    // Append an already-constructed node at the tail
+    void linkBack(Node* newNode) {
         newNode->setNext(&Node::NIL);
 
         if (isEmpty()) {
@@ -54,8 +43,8 @@ public:
         count++;
     }
 
-    void pushFront(const T& value) {
-        Node* newNode = new Node(value);
+    // Prepend an already-constructed node as head
+    void linkFront(Node* newNode) {
         newNode->setNext(head);
         head = newNode;
 
@@ -65,20 +54,103 @@ public:
         count++;
     }
 
+    void copyFrom(const SinglyLinkedList& other) {
+        Node* current = other.head;
+        while (current != &Node::NIL) {
+            push(current->getValue());
+            current = current->getNext();
+        }
+    }
+
+    // Take over other's nodes and their pool, leaving other empty
+    void moveFrom(SinglyLinkedList& other) {
+        head = other.head;
+        tail = other.tail;
+        count = other.count;
+        allocator = std::move(other.allocator);
+
+        other.head = &Node::NIL;
+        other.tail = &Node::NIL;
+        other.count = 0;
+    }
+
+public:
+    SinglyLinkedList() : head(&Node::NIL), tail(&Node::NIL), count(0) {}
+
+    ~SinglyLinkedList() {
+        clear();
+    }
+
+    SinglyLinkedList(const SinglyLinkedList& other) : head(&Node::NIL), tail(&Node::NIL), count(0) {
+        copyFrom(other);
+    }
+
+    SinglyLinkedList(SinglyLinkedList&& other) noexcept : head(&Node::NIL), tail(&Node::NIL), count(0) {
+        moveFrom(other);
+    }
+
+    SinglyLinkedList& operator=(const SinglyLinkedList& other) {
+        if (this != &other) {
+            clear();
+            copyFrom(other);
+        }
+        return *this;
+    }
+
+    SinglyLinkedList& operator=(SinglyLinkedList&& other) noexcept {
+        if (this != &other) {
+            clear();
+            moveFrom(other);
+        }
+        return *this;
+    }
+
+    void push(const T& value) {
+        linkBack(createNode(value));
+    }
+
+    void push(T&& value) {
+        linkBack(createNode(std::move(value)));
+    }
+
+    // Construct an element in place at the tail
+    template <class... Args>
+    T& emplace(Args&&... args) {
+        Node* newNode = createNode(std::forward<Args>(args)...);
+        linkBack(newNode);
+        return newNode->getValue();
+    }
+
+    void pushFront(const T& value) {
+        linkFront(createNode(value));
+    }
+
+    void pushFront(T&& value) {
+        linkFront(createNode(std::move(value)));
+    }
+
+    // Construct an element in place as head
+    template <class... Args>
+    T& emplaceFront(Args&&... args) {
+        Node* newNode = createNode(std::forward<Args>(args)...);
+        linkFront(newNode);
+        return newNode->getValue();
+    }
+
     T popFront() {
         if (isEmpty()) {
             throw runtime_error("Cannot pop from empty SinglyLinkedList");
         }
 
         Node* oldHead = head;
-        T value = oldHead->getValue();
+        T value = std::move(oldHead->getValue());
         head = head->getNext();
 
         if (head == &Node::NIL) {
             tail = &Node::NIL;
         }
 
-        delete oldHead;
+        destroyNode(oldHead);
         count--;
         return value;
     }
@@ -107,10 +179,26 @@ public:
         return count;
     }
 
+    // Bulk release: with a pooled allocator the slabs are freed at once, and
+    // the node walk is skipped entirely when T needs no destructor
     void clear() {
-        while (!isEmpty()) {
-            popFront();
+        if constexpr (!Alloc::bulkRelease || !is_trivially_destructible_v<T>) {
+            Node* current = head;
+            while (current != &Node::NIL) {
+                Node* toDelete = current;
+                current = current->getNext();
+                if constexpr (Alloc::bulkRelease) {
+                    toDelete->~Node();
+                }
+                else {
+                    destroyNode(toDelete);
+                }
+            }
         }
+        allocator.releaseAll();
+        head = &Node::NIL;
+        tail = &Node::NIL;
+        count = 0;
     }
 
     ForwardIterator<T> getIterator() {
@@ -144,7 +232,7 @@ public:
             if (head == &Node::NIL) {
                 tail = &Node::NIL;
             }
-            delete oldHead;
+            destroyNode(oldHead);
             count--;
             return true;
         }
@@ -159,7 +247,7 @@ public:
                 if (current == tail) {
                     tail = prev;
                 }
-                delete current;
+                destroyNode(current);
                 count--;
                 return true;
             }
@@ -1,4 +1,7 @@
 #pragma once
+#include <utility>
+
+using namespace std;
 
 template <class T>
 class SinglyLinkedNode {
@@ -11,14 +14,20 @@ public:
     static Node NIL;
 
     ~SinglyLinkedNode() = default;
-    SinglyLinkedNode(): value(T()), next(&NIL) {}
-    explicit SinglyLinkedNode(T value): value(value), next(&NIL) {};
+    SinglyLinkedNode(): value(), next(&NIL) {}
+    explicit SinglyLinkedNode(const T& value): value(value), next(&NIL) {}
+    explicit SinglyLinkedNode(T&& value): value(std::move(value)), next(&NIL) {}
+
+    // Construct the value in place from constructor arguments
+    template <class... Args>
+    explicit SinglyLinkedNode(in_place_t, Args&&... args)
+        : value(std::forward<Args>(args)...), next(&NIL) {}
 
     T& getValue() {
         return value;
     }
     void setValue(T fValue) {
-        this->value = fValue;
+        this->value = std::move(fValue);
     }
 
     Node* getNext() const {
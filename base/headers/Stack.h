@@ -2,17 +2,28 @@
 #include <iostream>
 #include "SinglyLinkedList.h"
 
-template <class T>
+// Nodes come from Alloc (a per-stack slab pool by default)
+template <class T, class Alloc = PoolAllocator<SinglyLinkedNode<T>>>
 class Stack {
 private:
-    SinglyLinkedList<T> list;
+    SinglyLinkedList<T, Alloc> list;
 public:
-    Stack(): list(SinglyLinkedList<T>()) {}
+    Stack(): list() {}
 
     void push(const T& value) {
         list.pushFront(value);
     }
 
+    void push(T&& value) {
+        list.pushFront(std::move(value));
+    }
+
+    // Construct an element in place on top
+    template <class... Args>
+    T& emplace(Args&&... args) {
+        return list.emplaceFront(std::forward<Args>(args)...);
+    }
+
     T pop() {
         return list.popFront();
     }
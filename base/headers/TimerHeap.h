@@ -0,0 +1,162 @@
+#pragma once
+#include "ArrayList.h"
+#include <cstdint>
+#include <utility>
+
+// Identifies one scheduled timer; stays safe to use after the timer fired or
+// was cancelled (the slot's generation no longer matches)
+struct TimerHandle {
+    int32_t slot = -1;
+    uint32_t generation = 0;
+
+    [[nodiscard]] bool isValid() const { return slot >= 0; }
+};
+
+// Timers keyed on absolute deadlines. A binary min-heap of slot indices orders
+// them by (deadline, scheduling order), so equal deadlines fire first-in
+// first-out. Values live in a slot array that reuses freed slots, and each slot
+// records its heap position so cancel is a direct removal, not a search.
+// schedule, cancel and each fired timer are O(log n).
+template <class T>
+class TimerHeap {
+private:
+    struct Slot {
+        T value;
+        double deadline;
+        uint64_t sequence;     // Tie-break: scheduling order
+        int32_t heapIndex;     // Position in heap, -1 when free
+        uint32_t generation;   // Bumped whenever the slot is freed
+    };
+
+    ArrayList<Slot> slots;
+    ArrayList<int32_t> heap;        // Slot indices, min-heap on (deadline, sequence)
+    ArrayList<int32_t> freeSlots;
+    uint64_t nextSequence;
+
+    bool earlier(int32_t a, int32_t b) const {
+        const Slot& first = slots[a];
+        const Slot& second = slots[b];
+        if (first.deadline != second.deadline) return first.deadline < second.deadline;
+        return first.sequence < second.sequence;
+    }
+
+    void place(int index, int32_t slot) {
+        heap[index] = slot;
+        slots[slot].heapIndex = index;
+    }
+
+    void siftUp(int index) {
+        int32_t slot = heap[index];
+        while (index > 0) {
+            int parent = (index - 1) / 2;
+            if (!earlier(slot, heap[parent])) break;
+            place(index, heap[parent]);
+            index = parent;
+        }
+        place(index, slot);
+    }
+
+    void siftDown(int index) {
+        int32_t slot = heap[index];
+        int count = heap.length();
+        while (true) {
+            int child = 2 * index + 1;
+            if (child >= count) break;
+            if (child + 1 < count && earlier(heap[child + 1], heap[child])) ++child;
+            if (!earlier(heap[child], slot)) break;
+            place(index, heap[child]);
+            index = child;
+        }
+        place(index, slot);
+    }
+
+    // Take the slot at heap position index out of the heap and free it
+    T removeAt(int index) {
+        int32_t slot = heap[index];
+        int32_t last = heap.pop();
+        if (index < heap.length()) {
+            place(index, last);
+            siftDown(index);
+            siftUp(slots[last].heapIndex);
+        }
+
+        Slot& freed = slots[slot];
+        freed.heapIndex = -1;
+        freed.generation++;
+        freeSlots.push(slot);
+        return std::move(freed.value);
+    }
+
+public:
+    TimerHeap() : nextSequence(0) {}
+
+    TimerHandle schedule(double deadline, T value) {
+        int32_t slot;
+        if (!freeSlots.isEmpty()) {
+            slot = freeSlots.pop();
+            slots[slot].value = std::move(value);
+        } else {
+            slot = slots.length();
+            slots.push(Slot{std::move(value), 0.0, 0, -1, 0});
+        }
+
+        Slot& entry = slots[slot];
+        entry.deadline = deadline;
+        entry.sequence = nextSequence++;
+        heap.push(slot);
+        siftUp(heap.length() - 1);
+        return TimerHandle{slot, entry.generation};
+    }
+
+    // False if the timer already fired or was cancelled
+    bool cancel(TimerHandle handle) {
+        if (!isPending(handle)) {
+            return false;
+        }
+        removeAt(slots[handle.slot].heapIndex);
+        return true;
+    }
+
+    [[nodiscard]]
+    bool isPending(TimerHandle handle) const {
+        return handle.slot >= 0 && handle.slot < slots.length() &&
+               slots[handle.slot].generation == handle.generation &&
+               slots[handle.slot].heapIndex >= 0;
+    }
+
+    // Remove every timer due at now and pass each value to fire, in deadline
+    // order. A timer is removed before it fires, so fire may schedule or cancel.
+    // Returns the number fired.
+    template <class Fire>
+    int fireDue(double now, Fire fire) {
+        int fired = 0;
+        while (!heap.isEmpty() && slots[heap[0]].deadline <= now) {
+            T value = removeAt(0);
+            fire(value);
+            ++fired;
+        }
+        return fired;
+    }
+
+    // Deadline of the next timer; only meaningful when not empty
+    [[nodiscard]]
+    double nextDeadline() const {
+        return slots[heap[0]].deadline;
+    }
+
+    [[nodiscard]]
+    bool isEmpty() const {
+        return heap.isEmpty();
+    }
+
+    [[nodiscard]]
+    int size() const {
+        return heap.length();
+    }
+
+    void clear() {
+        while (!heap.isEmpty()) {
+            removeAt(heap.length() - 1);
+        }
+    }
+};
@@ -0,0 +1,25 @@
+#pragma once
+#include <cstdint>
+
+// Choice effects, compiled once at load into a flat opcode stream.
+// A choice's program is its effects in script order followed by at most one
+// ACT_GOTO, so navigation always happens after every effect has been applied.
+// DialogueGraph::runProgram is the interpreter; the same stream is stored in
+// compiled images.
+
+enum ActionOpcode : uint32_t {
+    ACT_GOLD,      // operand: amount (negative spends)
+    ACT_ITEM,      // operand: index into the graph's (or image's) item spec table
+    ACT_XP,        // operand: amount
+    ACT_HEALTH,    // operand: amount (negative damages)
+    ACT_MANA,      // operand: amount
+    ACT_GOTO,      // operand: node index, or DialogueGraph::UNRESOLVED until linked
+    ACT_TIMELINE,  // operand: index into the graph's (or image's) timeline name table
+    ACT_OPCODE_COUNT
+};
+
+// Fixed 8-byte instruction; also the on-disk layout in compiled images
+struct ActionOp {
+    ActionOpcode opcode;
+    int32_t operand;
+};
@@ -0,0 +1,516 @@
+#include "Condition.h"
+#include <cctype>
+#include <charconv>
+#include <climits>
+
+namespace {
+    struct FieldName {
+        string_view name;
+        ConditionField field;
+    };
+
+    // Every PlayerStats / Inventory value a condition can test
+    const FieldName FIELD_NAMES[] = {
+        {"gold", FIELD_GOLD},
+        {"level", FIELD_LEVEL},
+        {"xp", FIELD_EXPERIENCE}, {"exp", FIELD_EXPERIENCE}, {"experience", FIELD_EXPERIENCE},
+        {"health", FIELD_HEALTH}, {"hp", FIELD_HEALTH},
+        {"maxhealth", FIELD_MAX_HEALTH}, {"maxhp", FIELD_MAX_HEALTH},
+        {"mana", FIELD_MANA}, {"mp", FIELD_MANA},
+        {"maxmana", FIELD_MAX_MANA}, {"maxmp", FIELD_MAX_MANA},
+        {"strength", FIELD_STRENGTH}, {"str", FIELD_STRENGTH},
+        {"defense", FIELD_DEFENSE}, {"def", FIELD_DEFENSE},
+        {"intelligence", FIELD_INTELLIGENCE}, {"int", FIELD_INTELLIGENCE},
+        {"agility", FIELD_AGILITY}, {"agi", FIELD_AGILITY},
+        {"items", FIELD_ITEM_COUNT},
+        {"weight", FIELD_WEIGHT},
+        {"maxweight", FIELD_MAX_WEIGHT},
+    };
+
+    constexpr int MAX_NESTING = 16;
+
+    bool equalsIgnoreCase(string_view a, string_view b) {
+        if (a.size() != b.size()) return false;
+        for (size_t i = 0; i < a.size(); ++i) {
+            if (tolower(static_cast<unsigned char>(a[i])) != b[i]) return false;
+        }
+        return true;
+    }
+
+    // Recursive-descent compiler emitting postfix code; tracks the evaluation
+    // stack depth so the interpreter's fixed stack can never overflow
+    class ConditionParser {
+    private:
+        string_view text;
+        size_t pos;
+        int nesting;
+        int depth;
+        ArrayList<ConditionOp>& code;
+        ArrayList<string>& names;
+
+    public:
+        int maxDepth;
+        string error;
+
+        ConditionParser(string_view source, ArrayList<ConditionOp>& out, ArrayList<string>& outNames)
+            : text(source), pos(0), nesting(0), depth(0), code(out), names(outNames), maxDepth(0) {}
+
+        bool parse() {
+            if (!parseOr()) return false;
+            skipSpace();
+            if (pos != text.size()) {
+                return fail("unexpected '" + string(text.substr(pos)) + "'");
+            }
+            return true;
+        }
+
+    private:
+        bool fail(string message) {
+            if (error.empty()) error = std::move(message);
+            return false;
+        }
+
+        void skipSpace() {
+            while (pos < text.size() && isspace(static_cast<unsigned char>(text[pos]))) ++pos;
+        }
+
+        bool match(string_view token) {
+            skipSpace();
+            if (text.substr(pos).starts_with(token)) {
+                pos += token.size();
+                return true;
+            }
+            return false;
+        }
+
+        // stackEffect: +1 for pushes, -1 for binary operators, 0 for NOT
+        bool emit(ConditionOpcode opcode, int32_t operand, int stackEffect) {
+            code.push(ConditionOp{opcode, operand});
+            depth += stackEffect;
+            if (depth > maxDepth) maxDepth = depth;
+            if (maxDepth > ConditionProgram::MAX_STACK) {
+                return fail("condition is too complex");
+            }
+            return true;
+        }
+
+        bool parseOr() {
+            if (!parseAnd()) return false;
+            while (match("||")) {
+                if (!parseAnd() || !emit(COND_OR, 0, -1)) return false;
+            }
+            return true;
+        }
+
+        bool parseAnd() {
+            if (!parseUnary()) return false;
+            while (match("&&")) {
+                if (!parseUnary() || !emit(COND_AND, 0, -1)) return false;
+            }
+            return true;
+        }
+
+        bool parseUnary() {
+            skipSpace();
+            if (pos < text.size() && text[pos] == '!' && !text.substr(pos).starts_with("!=")) {
+                ++pos;
+                return parseUnary() && emit(COND_NOT, 0, 0);
+            }
+            if (match("(")) {
+                if (++nesting > MAX_NESTING) return fail("condition nests too deeply");
+                if (!parseOr()) return false;
+                if (!match(")")) return fail("expected ')'");
+                --nesting;
+                return true;
+            }
+            if (match("hasitem:")) {
+                return parseItemName();
+            }
+
+            size_t start = pos;
+            string_view word = readWord();
+            if (equalsIgnoreCase(word, "true")) return emit(COND_PUSH_INT, 1, 1);
+            if (equalsIgnoreCase(word, "false")) return emit(COND_PUSH_INT, 0, 1);
+            pos = start;
+            return parseComparison();
+        }
+
+        bool parseItemName() {
+            skipSpace();
+            size_t start = pos;
+            while (pos < text.size() && text[pos] != ')' &&
+                   !text.substr(pos).starts_with("&&") && !text.substr(pos).starts_with("||")) {
+                ++pos;
+            }
+            string_view name = text.substr(start, pos - start);
+            while (!name.empty() && isspace(static_cast<unsigned char>(name.back()))) name.remove_suffix(1);
+            if (name.empty()) return fail("hasitem: needs an item name");
+
+            names.push(string(name));
+            return emit(COND_HAS_ITEM, names.length() - 1, 1);
+        }
+
+        bool parseComparison() {
+            if (!parseOperand()) return false;
+
+            ConditionOpcode opcode;
+            if (match(">=")) opcode = COND_GE;
+            else if (match("<=")) opcode = COND_LE;
+            else if (match("==")) opcode = COND_EQ;
+            else if (match("!=")) opcode = COND_NE;
+            else if (match(">")) opcode = COND_GT;
+            else if (match("<")) opcode = COND_LT;
+            else return fail("expected a comparison operator in '" + string(text) + "'");
+
+            return parseOperand() && emit(opcode, 0, -1);
+        }
+
+        string_view readWord() {
+            skipSpace();
+            size_t start = pos;
+            while (pos < text.size() && (isalnum(static_cast<unsigned char>(text[pos])) || text[pos] == '_')) ++pos;
+            return text.substr(start, pos - start);
+        }
+
+        bool parseOperand() {
+            skipSpace();
+            if (pos < text.size() && (text[pos] == '-' || isdigit(static_cast<unsigned char>(text[pos])))) {
+                int32_t value = 0;
+                auto [end, status] = from_chars(text.data() + pos, text.data() + text.size(), value);
+                if (status != errc()) {
+                    return fail("bad number in '" + string(text) + "'");
+                }
+                pos = static_cast<size_t>(end - text.data());
+                return emit(COND_PUSH_INT, value, 1);
+            }
+
+            string_view word = readWord();
+            if (word.empty()) {
+                return fail("expected a field or number in '" + string(text) + "'");
+            }
+            for (const FieldName& entry : FIELD_NAMES) {
+                if (equalsIgnoreCase(word, entry.name)) {
+                    return emit(COND_LOAD_FIELD, entry.field, 1);
+                }
+            }
+            return fail("unknown condition term '" + string(word) + "'");
+        }
+    };
+}
+
+bool ConditionProgram::append(string_view text, string& error) {
+    ArrayList<ConditionOp> compiled;
+    ArrayList<string> compiledNames;
+    ConditionParser parser(text, compiled, compiledNames);
+
+    if (!parser.parse()) {
+        error = parser.error;
+        return false;
+    }
+    // An existing program leaves one value on the stack underneath the new one
+    if (!code.isEmpty() && parser.maxDepth + 1 > MAX_STACK) {
+        error = "condition is too complex";
+        return false;
+    }
+
+    int nameBase = itemNames.length();
+    for (string& name : compiledNames) {
+        itemNames.push(std::move(name));
+    }
+    bool combine = !code.isEmpty();
+    for (ConditionOp op : compiled) {
+        if (op.opcode == COND_HAS_ITEM) {
+            op.operand += nameBase;
+        }
+        code.push(op);
+    }
+    if (combine) {
+        code.push(ConditionOp{COND_AND, 0});
+    }
+
+    if (!source.empty()) source += " && ";
+    source += text;
+    return true;
+}
+
+void ConditionProgram::makeNeverTrue(string_view text) {
+    code.clear();
+    itemNames.clear();
+    code.push(ConditionOp{COND_PUSH_INT, 0});
+    source = string(text);
+}
+
+namespace {
+    // Satisfiability: the postfix code is rebuilt as a tree, negations are pushed
+    // down to the atoms, and the expression is expanded into OR-of-AND terms.
+    // A term is satisfiable unless its atoms contradict each other.
+    constexpr int MAX_TERMS = 256;
+
+    struct ExprNode {
+        ConditionOp op;
+        int left;
+        int right;
+    };
+
+    enum AtomKind { ATOM_FALSE, ATOM_FIELD, ATOM_ITEM };
+
+    struct Atom {
+        AtomKind kind;
+        int32_t operand;        // Field for ATOM_FIELD, item name index for ATOM_ITEM
+        ConditionOpcode compare;
+        int64_t value;
+        bool positive;          // ATOM_ITEM: has the item (true) or lacks it
+    };
+
+    using Term = ArrayList<Atom>;
+    using Terms = ArrayList<Term>;
+
+    ConditionOpcode negateCompare(ConditionOpcode opcode) {
+        switch (opcode) {
+            case COND_GE: return COND_LT;
+            case COND_GT: return COND_LE;
+            case COND_LE: return COND_GT;
+            case COND_LT: return COND_GE;
+            case COND_EQ: return COND_NE;
+            default: return COND_EQ;
+        }
+    }
+
+    // a OP b  ==  b MIRROR(OP) a
+    ConditionOpcode mirrorCompare(ConditionOpcode opcode) {
+        switch (opcode) {
+            case COND_GE: return COND_LE;
+            case COND_GT: return COND_LT;
+            case COND_LE: return COND_GE;
+            case COND_LT: return COND_GT;
+            default: return opcode;
+        }
+    }
+
+    bool compareConstants(ConditionOpcode opcode, int64_t a, int64_t b) {
+        switch (opcode) {
+            case COND_GE: return a >= b;
+            case COND_GT: return a > b;
+            case COND_LE: return a <= b;
+            case COND_LT: return a < b;
+            case COND_EQ: return a == b;
+            default: return a != b;
+        }
+    }
+
+    Terms single(Term term) {
+        Terms terms;
+        terms.push(std::move(term));
+        return terms;
+    }
+
+    Terms constant(bool value) {
+        Term term;
+        if (!value) {
+            term.push(Atom{ATOM_FALSE, 0, COND_EQ, 0, true});
+        }
+        return single(std::move(term)); // An empty term is always true
+    }
+
+    // Expand node (negated if asked) into terms; false if it grows past MAX_TERMS
+    bool expand(const ArrayList<ExprNode>& tree, int index, bool negated, Terms& out) {
+        const ExprNode& node = tree[index];
+        switch (node.op.opcode) {
+            case COND_NOT:
+                return expand(tree, node.left, !negated, out);
+
+            case COND_AND:
+            case COND_OR: {
+                Terms left, right;
+                if (!expand(tree, node.left, negated, left) || !expand(tree, node.right, negated, right)) {
+                    return false;
+                }
+                bool conjunction = (node.op.opcode == COND_AND) != negated;
+                if (!conjunction) {
+                    if (left.length() + right.length() > MAX_TERMS) return false;
+                    out = std::move(left);
+                    for (Term& term : right) out.push(std::move(term));
+                    return true;
+                }
+                if (left.length() * right.length() > MAX_TERMS) return false;
+                out.clear();
+                for (const Term& a : left) {
+                    for (const Term& b : right) {
+                        Term& combined = out.emplace(a);
+                        for (const Atom& atom : b) combined.push(atom);
+                    }
+                }
+                return true;
+            }
+
+            case COND_PUSH_INT:
+                out = constant((node.op.operand != 0) != negated);
+                return true;
+
+            case COND_HAS_ITEM: {
+                Term term;
+                term.push(Atom{ATOM_ITEM, node.op.operand, COND_EQ, 0, !negated});
+                out = single(std::move(term));
+                return true;
+            }
+
+            case COND_GE: case COND_GT: case COND_LE: case COND_LT: case COND_EQ: case COND_NE: {
+                const ConditionOp& left = tree[node.left].op;
+                const ConditionOp& right = tree[node.right].op;
+                ConditionOpcode compare = negated ? negateCompare(node.op.opcode) : node.op.opcode;
+                if (left.opcode == COND_PUSH_INT && right.opcode == COND_PUSH_INT) {
+                    out = constant(compareConstants(compare, left.operand, right.operand));
+                } else if (left.opcode == COND_LOAD_FIELD && right.opcode == COND_PUSH_INT) {
+                    Term term;
+                    term.push(Atom{ATOM_FIELD, left.operand, compare, right.operand, true});
+                    out = single(std::move(term));
+                } else if (left.opcode == COND_PUSH_INT && right.opcode == COND_LOAD_FIELD) {
+                    Term term;
+                    term.push(Atom{ATOM_FIELD, right.operand, mirrorCompare(compare), left.operand, true});
+                    out = single(std::move(term));
+                } else {
+                    out = constant(true); // Field against field: not tracked
+                }
+                return true;
+            }
+
+            default:
+                out = constant(true); // A bare field used as a truth value
+                return true;
+        }
+    }
+
+    bool termSatisfiable(const Term& term, const ArrayList<string>& itemNames) {
+        int64_t low[FIELD_COUNT];
+        int64_t high[FIELD_COUNT];
+        for (int field = 0; field < FIELD_COUNT; ++field) {
+            low[field] = INT32_MIN;
+            high[field] = INT32_MAX;
+        }
+        // Values that cannot go below these
+        low[FIELD_GOLD] = low[FIELD_ITEM_COUNT] = low[FIELD_WEIGHT] = low[FIELD_MAX_WEIGHT] = 0;
+        low[FIELD_LEVEL] = 1;
+
+        for (const Atom& atom : term) {
+            if (atom.kind == ATOM_FALSE) return false;
+            if (atom.kind != ATOM_FIELD) continue;
+            int64_t& lo = low[atom.operand];
+            int64_t& hi = high[atom.operand];
+            switch (atom.compare) {
+                case COND_GE: lo = max(lo, atom.value); break;
+                case COND_GT: lo = max(lo, atom.value + 1); break;
+                case COND_LE: hi = min(hi, atom.value); break;
+                case COND_LT: hi = min(hi, atom.value - 1); break;
+                case COND_EQ: lo = max(lo, atom.value); hi = min(hi, atom.value); break;
+                default: break; // != is checked below, once the bounds are final
+            }
+        }
+
+        for (int i = 0; i < term.length(); ++i) {
+            const Atom& atom = term[i];
+            if (atom.kind == ATOM_FIELD) {
+                if (low[atom.operand] > high[atom.operand]) return false;
+                if (atom.compare == COND_NE && low[atom.operand] == high[atom.operand] &&
+                    low[atom.operand] == atom.value) {
+                    return false;
+                }
+            } else if (atom.kind == ATOM_ITEM) {
+                for (int j = i + 1; j < term.length(); ++j) {
+                    const Atom& other = term[j];
+                    if (other.kind == ATOM_ITEM && other.positive != atom.positive &&
+                        itemNames[other.operand] == itemNames[atom.operand]) {
+                        return false;
+                    }
+                }
+            }
+        }
+        return true;
+    }
+}
+
+bool ConditionProgram::isSatisfiable() const {
+    if (code.isEmpty()) {
+        return true;
+    }
+
+    // Rebuild the tree; the code came from the compiler, so it is well formed
+    ArrayList<ExprNode> tree;
+    int stack[MAX_STACK];
+    int top = 0;
+    for (const ConditionOp& op : code) {
+        ExprNode node{op, -1, -1};
+        if (op.opcode == COND_NOT) {
+            node.left = stack[--top];
+        } else if (op.opcode >= COND_GE && op.opcode <= COND_OR) {
+            node.right = stack[--top];
+            node.left = stack[--top];
+        }
+        tree.push(node);
+        stack[top++] = tree.length() - 1;
+    }
+
+    Terms terms;
+    if (!expand(tree, stack[top - 1], false, terms)) {
+        return true; // Too large to decide
+    }
+    for (const Term& term : terms) {
+        if (termSatisfiable(term, itemNames)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool ConditionProgram::verify(const ConditionOp* ops, int length, int nameCount) {
+    int depth = 0;
+    for (int i = 0; i < length; ++i) {
+        const ConditionOp& op = ops[i];
+        switch (op.opcode) {
+            case COND_PUSH_INT:
+                ++depth;
+                break;
+            case COND_LOAD_FIELD:
+                if (op.operand < 0 || op.operand >= FIELD_COUNT) return false;
+                ++depth;
+                break;
+            case COND_HAS_ITEM:
+                if (op.operand < 0 || op.operand >= nameCount) return false;
+                ++depth;
+                break;
+            case COND_NOT:
+                if (depth < 1) return false;
+                break;
+            case COND_GE: case COND_GT: case COND_LE: case COND_LT: case COND_EQ: case COND_NE:
+            case COND_AND: case COND_OR:
+                if (depth < 2) return false;
+                --depth;
+                break;
+            default:
+                return false;
+        }
+        if (depth > MAX_STACK) return false;
+    }
+    return length == 0 || depth == 1;
+}
+
+int ConditionProgram::fieldValue(const Player& player, int32_t field) {
+    const PlayerStats& stats = player.getStats();
+    const Inventory& inventory = player.getInventory();
+    switch (field) {
+        case FIELD_GOLD: return inventory.getGold();
+        case FIELD_LEVEL: return stats.getLevel();
+        case FIELD_EXPERIENCE: return stats.getExperience();
+        case FIELD_HEALTH: return stats.getCurrentHealth();
+        case FIELD_MAX_HEALTH: return stats.getMaxHealth();
+        case FIELD_MANA: return stats.getCurrentMana();
+        case FIELD_MAX_MANA: return stats.getMaxMana();
+        case FIELD_STRENGTH: return stats.getStrength();
+        case FIELD_DEFENSE: return stats.getDefense();
+        case FIELD_INTELLIGENCE: return stats.getIntelligence();
+        case FIELD_AGILITY: return stats.getAgility();
+        case FIELD_ITEM_COUNT: return inventory.getItemCount();
+        case FIELD_WEIGHT: return inventory.getCurrentWeight();
+        case FIELD_MAX_WEIGHT: return inventory.getMaxWeight();
+        default: return 0;
+    }
+}
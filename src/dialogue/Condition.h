@@ -0,0 +1,111 @@
+#pragma once
+#include "ArrayList.h"
+#include "game/Player.h"
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+using namespace std;
+
+// Choice conditions, compiled once at load into postfix bytecode.
+//
+// Grammar (whitespace-insensitive, field names case-insensitive):
+//   expr       := and ('||' and)*
+//   and        := unary ('&&' unary)*
+//   unary      := '!' unary | '(' expr ')' | 'hasitem:' NAME | 'true' | 'false' | comparison
+//   comparison := operand ('>=' | '>' | '<=' | '<' | '==' | '!=') operand
+//   operand    := FIELD | ['-'] INTEGER
+// NAME runs up to the next '&&', '||' or ')'. Fields are listed in Condition.cpp
+// (gold, level, xp, health, maxhealth, mana, maxmana, strength, defense,
+// intelligence, agility, items, weight, maxweight and their short aliases).
+// Unknown fields and malformed expressions are compile errors.
+
+enum ConditionOpcode : uint32_t {
+    COND_PUSH_INT,     // operand: value
+    COND_LOAD_FIELD,   // operand: ConditionField
+    COND_HAS_ITEM,     // operand: index into the program's item names
+    COND_GE, COND_GT, COND_LE, COND_LT, COND_EQ, COND_NE,
+    COND_NOT,
+    COND_AND,
+    COND_OR,
+    COND_OPCODE_COUNT
+};
+
+enum ConditionField : int32_t {
+    FIELD_GOLD, FIELD_LEVEL, FIELD_EXPERIENCE,
+    FIELD_HEALTH, FIELD_MAX_HEALTH, FIELD_MANA, FIELD_MAX_MANA,
+    FIELD_STRENGTH, FIELD_DEFENSE, FIELD_INTELLIGENCE, FIELD_AGILITY,
+    FIELD_ITEM_COUNT, FIELD_WEIGHT, FIELD_MAX_WEIGHT,
+    FIELD_COUNT
+};
+
+// Fixed 8-byte instruction; also the on-disk layout in compiled images
+struct ConditionOp {
+    ConditionOpcode opcode;
+    int32_t operand;
+};
+
+class ConditionProgram {
+private:
+    ArrayList<ConditionOp> code;
+    ArrayList<string> itemNames;
+    string source;       // Original text, for messages
+
+    static int fieldValue(const Player& player, int32_t field);
+
+public:
+    static constexpr int MAX_STACK = 32;
+
+    // Compile source and AND it onto the program. On failure the program is
+    // left unchanged and error describes the problem.
+    bool append(string_view text, string& error);
+
+    // Replace the program with one that never passes (used for rejected conditions)
+    void makeNeverTrue(string_view text);
+
+    [[nodiscard]] bool isEmpty() const { return code.isEmpty(); }
+    [[nodiscard]] const string& getSource() const { return source; }
+    const ArrayList<ConditionOp>& getCode() const { return code; }
+    const ArrayList<string>& getItemNames() const { return itemNames; }
+
+    bool evaluate(const Player& player) const {
+        return run(code.getData(), code.length(), player,
+                   [this](int32_t index) { return string_view(itemNames[index]); });
+    }
+
+    // Static check for conditions no player can pass: contradictory bounds on
+    // one field (gold > 10 && gold < 5), hasitem and !hasitem of the same item,
+    // constant false, or a field outside its possible range. Conservative: true
+    // when unsure (field-to-field comparisons, very large expressions).
+    [[nodiscard]] bool isSatisfiable() const;
+
+    // Stack depth and operand check for code from an untrusted source (images)
+    static bool verify(const ConditionOp* ops, int length, int nameCount);
+
+    // Interpreter shared by parsed and image-backed programs; itemName maps a
+    // COND_HAS_ITEM operand to the item name. An empty program passes.
+    template <class ItemNames>
+    static bool run(const ConditionOp* ops, int length, const Player& player, ItemNames itemName) {
+        int32_t stack[MAX_STACK];
+        int top = 0;
+        for (int i = 0; i < length; ++i) {
+            const ConditionOp& op = ops[i];
+            switch (op.opcode) {
+                case COND_PUSH_INT: stack[top++] = op.operand; break;
+                case COND_LOAD_FIELD: stack[top++] = fieldValue(player, op.operand); break;
+                case COND_HAS_ITEM: stack[top++] = player.getInventory().hasItem(itemName(op.operand)); break;
+                case COND_GE: --top; stack[top - 1] = stack[top - 1] >= stack[top]; break;
+                case COND_GT: --top; stack[top - 1] = stack[top - 1] > stack[top]; break;
+                case COND_LE: --top; stack[top - 1] = stack[top - 1] <= stack[top]; break;
+                case COND_LT: --top; stack[top - 1] = stack[top - 1] < stack[top]; break;
+                case COND_EQ: --top; stack[top - 1] = stack[top - 1] == stack[top]; break;
+                case COND_NE: --top; stack[top - 1] = stack[top - 1] != stack[top]; break;
+                case COND_NOT: stack[top - 1] = !stack[top - 1]; break;
+                case COND_AND: --top; stack[top - 1] = stack[top - 1] && stack[top]; break;
+                case COND_OR: --top; stack[top - 1] = stack[top - 1] || stack[top]; break;
+                default: return false;
+            }
+        }
+        return top == 0 || stack[top - 1] != 0;
+    }
+};
@@ -2,10 +2,14 @@
 
 #include <iostream>
 #include "Element.h"  // Visitor pattern base class
-#include "List.h"  // Custom List data structure
+#include "ArrayList.h"  // Contiguous list with inline small-buffer storage
 #include "Choice.h"
 #include <string>
 
+#ifndef MAX_CHOICES
+#define MAX_CHOICES 5
+#endif
+
 using namespace std;
 
 // Dialogue class: Represents a single dialogue node in the conversation tree
@@ -14,8 +18,9 @@ public:
     string speaker;    // Name of the character speaking
     string message;    // Dialogue text content
 
-    // List data structure: Available choices for player response
-    List<Choice> choices;
+    // SmallList data structure: Available choices for player response
+    // (up to MAX_CHOICES stored inline, so typical nodes never allocate)
+    SmallList<Choice, MAX_CHOICES> choices;
 
     // Accept visitor for processing
     void accept(Visitor& visitor) override;
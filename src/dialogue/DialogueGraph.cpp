@@ -1,8 +1,16 @@
 #include <iostream>
 #include "dialogue/DialogueGraph.h"
+#include "dialogue/ScriptFile.h"
+#include <algorithm>
+#include <cstring>
 #include <fstream>
 #include <string>
-#include "SFML/Audio/Music.hpp"
+#include <string_view>
+#include <atomic>
+#include <charconv>
+#include <filesystem>
+#include <thread>
+#include <stdexcept>
 
 using namespace std;
 
@@ -13,14 +21,21 @@ Action::Action(Type t, int val) : type(t), intParam(val) {}
 Action::Action(Type t, string str, int val)
     : type(t), stringParam(std::move(str)), intParam(val) {}
 
-ChoiceInfo::ChoiceInfo() : actions(), condition(List<string>{})
+ChoiceInfo::ChoiceInfo() : program(), condition()
 {}
 
 NodeInfo::NodeInfo() = default;
 
-DialogueGraph::DialogueGraph(Player& player) : rootNodeId("root"), playerRef(&player), rootTree(nullptr) {}
+DialogueGraph::DialogueGraph(Player& player)
+    : pagedLoading(false), activeView(0), rootNodeId("root"), playerRef(&player), rootNode(NO_TARGET), lazyBuild(false),
+      reloadCount(0), clock(0.0) {}
 
 DialogueGraph::~DialogueGraph() {
+    clearSources();
+}
+
+// Delete all parsed script data (NodeInfos and the node index)
+void DialogueGraph::clearSources() {
     // Iterate through all NodeInfo objects for cleanup
     auto nodeInfoIt = allNodeInfos.getIterator();
     auto nodeInfoEnd = nodeInfoIt.end();
@@ -28,30 +43,23 @@ DialogueGraph::~DialogueGraph() {
         delete nodeInfoIt.getCurrent()->getValue();
         ++nodeInfoIt;
     }
+    allNodeInfos.clear();
+
+    nodeIndex.clear(); // Keys viewed the NodeInfos just deleted
+    allFiles.clear();
+    itemSpecs.clear();
+    itemSpecIndex.clear();
+    itemPrototypes.clear();
+    timelineNames.clear();
+    timelineNameIndex.clear();
+}
 
-    // Iterate through all tree nodes for cleanup
-    auto treeIt = allTreeNodes.getIterator();
-    auto treeEnd = treeIt.end();
-    while (treeIt != treeEnd) {
-        delete treeIt.getCurrent()->getValue();
-        ++treeIt;
-    }
-
-    // Clean up nested hash tables by iterating through file list
-    auto fileIt = allFiles.getIterator();
-    auto endFileIt = fileIt.end();
-    while (fileIt != endFileIt) {
-        // Search for inner hash table and delete it
-        auto** fileNodes = fileNodeData.search(fileIt.getCurrent()->getValue());
-        if (fileNodes) {
-            delete *fileNodes;
-        }
-        ++fileIt;
-    }
-    fileNodeData.clear();
+void DialogueGraph::setPageBudget(size_t budgetBytes) {
+    pagedLoading = budgetBytes > 0;
+    pageCache.setBudget(budgetBytes);
 }
 
-void DialogueGraph::setDialogueStartCallback(function<void(NTree<Dialogue, MAX_CHOICES>*, const string&)> callback) {
+void DialogueGraph::setDialogueStartCallback(function<void(Dialogue*, string_view)> callback) {
     onDialogueStart = std::move(callback);
 }
 
@@ -63,405 +71,1258 @@ bool DialogueGraph::loadAdditionalFile(const string& filename) {
     return loadFile(filename, false);
 }
 
-NTree<Dialogue, MAX_CHOICES>* DialogueGraph::buildTree() {
-    rootTree = buildNode(rootNodeId);
-    return rootTree;
+Dialogue* DialogueGraph::buildTree() {
+    // A compiled image is fully linked already
+    rootNode = image.isOpen() ? image.getRootNode() : buildNode(rootNodeId);
+    return showNode(rootNode);
 }
 
-NTree<Dialogue, MAX_CHOICES>* DialogueGraph::getNode(const string& nodeId) {
-    // O(1) lookup in built nodes cache
+Dialogue* DialogueGraph::getNode(string_view nodeId) {
+    return showNode(findNode(nodeId));
+}
+
+int DialogueGraph::findNode(string_view nodeId) {
+    if (image.isOpen()) {
+        int index = image.findNode(nodeId);
+        if (index == NO_TARGET) {
+            cerr << "Node not found: " << nodeId << endl;
+        }
+        return index;
+    }
+
+    // O(1) lookup in built nodes index (string_view probe, no temporary string)
     auto* result = builtNodes.search(nodeId);
     if (result) {
-        return *result; // Cache hit - return existing tree node
+        return *result; // Cache hit - node already compiled
     }
-    // Cache miss - build node on demand (needed for loading saved games)
+    // Cache miss - compile node on demand (needed for loading saved games)
     return buildNode(nodeId);
 }
 
+// Fill the inactive view from the compiled node and make it the shown one
+Dialogue* DialogueGraph::showNode(int nodeIndex) {
+    if (nodeIndex == NO_TARGET) {
+        return nullptr;
+    }
+
+    activeView ^= 1;
+    Dialogue& view = views[activeView];
+    const CompiledNode& node = nodes[nodeIndex];
+    const NodeInfo* info = node.info ? pageIn(nodeIndex) : nullptr;
+
+    if (info) {
+        view.speaker = info->speaker;
+        view.message = info->message;
+    } else {
+        const ImageNode& record = image.getNode(nodeIndex);
+        view.speaker = image.getString(record.speaker);
+        view.message = image.getString(record.message);
+    }
+
+    view.choices.clear();
+    for (int i = 0; i < node.choiceCount; ++i) {
+        int edgeIndex = node.firstChoice + i;
+        Choice& choice = view.choices.emplace();
+        const ChoiceInfo* choiceInfo = choiceAt(nodeIndex, edgeIndex);
+        if (choiceInfo) {
+            choice.text = choiceInfo->text;
+        } else {
+            choice.text = image.getString(image.getChoice(edgeIndex).text);
+        }
+        choice.action = [this, nodeIndex, edgeIndex]() { fireChoice(nodeIndex, edgeIndex); };
+    }
+    return &view;
+}
+
+string_view DialogueGraph::getNodeId(int nodeIndex) const {
+    const NodeInfo* info = nodes[nodeIndex].info;
+    return info ? string_view(info->nodeId) : image.getString(image.getNode(nodeIndex).id);
+}
+
+// Parsed choice behind an edge; null for image-backed graphs. A paged node is
+// read back first, and the result lasts until another node is read back.
+ChoiceInfo* DialogueGraph::choiceAt(int nodeIndex, int edgeIndex) const {
+    if (ChoiceInfo* info = edges[edgeIndex].info) {
+        return info;
+    }
+    const CompiledNode& node = nodes[nodeIndex];
+    if (!node.info) {
+        return nullptr;
+    }
+    return &pageIn(nodeIndex)->choices[edgeIndex - node.firstChoice];
+}
+
+// The NodeInfo with a compiled node's text and choices: the node's own, or for
+// a paged node a copy parsed again from its script range and kept in pageCache
+NodeInfo* DialogueGraph::pageIn(int index) const {
+    NodeInfo* header = nodes[index].info;
+    if (!header->isPaged()) {
+        return header;
+    }
+    if (unique_ptr<NodeInfo>* cached = pageCache.get(index)) {
+        return cached->get();
+    }
+
+    const PageRef& page = header->page;
+    const string& filename = allFiles[page.file];
+    const NodeLocation* location = nodeIndex.search(string_view(header->nodeId));
+    int lineNumber = location ? location->line : 0;
+
+    string block(page.length, '\0');
+    ifstream in(filename, ios::binary);
+    in.seekg(static_cast<streamoff>(page.offset));
+    in.read(block.data(), static_cast<streamsize>(block.size()));
+
+    auto payload = make_unique<NodeInfo>();
+    payload->nodeId = header->nodeId;
+    ParsedScript parsed;
+    string_view text(block);
+    bool intact = in && text.starts_with("NODE:");
+    try {
+        // Same line handling as parseScript, starting after the NODE: line
+        size_t start = intact ? text.find('\n') : string_view::npos;
+        while (start != string_view::npos && start < text.size()) {
+            ++start;
+            ++lineNumber;
+            size_t end = text.find('\n', start);
+            string_view line = trimView(text.substr(start, end == string_view::npos ? string_view::npos : end - start));
+            if (!line.empty() && line[0] != '#') {
+                parseNodeLine(line, *payload, parsed, filename, lineNumber);
+            }
+            start = end;
+        }
+    } catch (const exception& e) {
+        cerr << filename << ":" << lineNumber << ": " << e.what() << endl;
+        intact = false;
+    }
+    cerr << parsed.diagnostics;
+    remapOperands(*payload, adoptItemSpecs(parsed), adoptTimelineNames(parsed));
+
+    // Edges were laid out from the header's count; keep them matching
+    if (!intact || payload->choices.length() != page.choiceCount) {
+        cerr << filename << ": node '" << header->nodeId << "' changed since the script was loaded" << endl;
+        while (payload->choices.length() > page.choiceCount) {
+            payload->choices.pop();
+        }
+        while (payload->choices.length() < page.choiceCount) {
+            payload->choices.emplace().text = "...";
+        }
+    }
+
+    size_t cost = payloadBytes(*payload);
+    return pageCache.put(index, std::move(payload), cost).get();
+}
+
+// Approximate heap footprint of a read-back node, charged against the page budget
+size_t DialogueGraph::payloadBytes(const NodeInfo& info) {
+    size_t bytes = sizeof(NodeInfo) + info.nodeId.capacity() + info.speaker.capacity() + info.message.capacity();
+    for (const ChoiceInfo& choice : info.choices) {
+        bytes += sizeof(ChoiceInfo) + 2 * sizeof(void*) + choice.text.capacity() + choice.targetNodeId.capacity() +
+                 choice.condition.getSource().capacity() +
+                 sizeof(ConditionOp) * static_cast<size_t>(choice.condition.getCode().length());
+    }
+    return bytes;
+}
+
+void DialogueGraph::clearCompiled() {
+    nodes.clear();
+    edges.clear();
+    builtNodes.clear();
+    pageCache.clear(); // Keyed by the node indices just dropped
+    rootNode = NO_TARGET;
+}
+
 bool DialogueGraph::loadFile(const string& filename, bool isFirstFile) {
     if (isFirstFile) {
         // Clean up existing data before loading new file
-        auto nodeInfoIt = allNodeInfos.getIterator();
-        auto nodeInfoEnd = nodeInfoIt.end();
-        while (nodeInfoIt != nodeInfoEnd) {
-            delete nodeInfoIt.getCurrent()->getValue();
-            ++nodeInfoIt;
-        }
-        allNodeInfos.clear();
-
-        // Delete all nested hash tables
-        auto fileIt = allFiles.getIterator();
-        auto endFileIt = fileIt.end();
-        while (fileIt != endFileIt) {
-			auto** fileNodes = fileNodeData.search(fileIt.getCurrent()->getValue());
-			if (fileNodes) {
-				delete *fileNodes;
-			}
-			++fileIt;
-		}
-        fileNodeData.clear();
-        allFiles.clear();
-    }
-
-    ifstream file(filename);
-    if (!file.is_open()) {
-        cerr << "Failed to open dialogue file: " << filename << endl;
+        clearSources();
+        clearCompiled(); // Compiled records point into the sources just deleted
+        image.close();
+    }
+    else if (image.isOpen()) {
+        cerr << "Cannot add " << filename << " to a graph loaded from a compiled image" << endl;
         return false;
     }
 
-    // Track this file for later iteration
-    allFiles.push(filename);
-    // Create inner hash table for this file's nodes
-    auto* currentFileNodes = new HashTable<string, NodeInfo*>();
-    fileNodeData.insert(filename, currentFileNodes);
+    ParsedScript parsed;
+    parseScript(filename, parsed, pagedLoading);
+    return mergeScript(filename, parsed, isFirstFile);
+}
+
+DialogueGraph::ParsedScript::~ParsedScript() {
+    for (const ParsedNode& node : nodes) {
+        delete node.info; // Only nodes that were never merged
+    }
+}
+
+// Specs are parsed here, on the worker, so a bad bonus fails the load like a
+// bad gold amount instead of failing every time the choice is picked
+int DialogueGraph::ParsedScript::internItemSpec(string_view itemSpec) {
+    if (auto* existing = itemSpecIndex.search(itemSpec)) {
+        return *existing;
+    }
+    itemDefinitions.push(ItemRegistry::parseSpec(itemSpec));
+    itemSpecs.push(string(itemSpec));
+    itemSpecIndex.insert(string(itemSpec), itemSpecs.length() - 1);
+    return itemSpecs.length() - 1;
+}
+
+int DialogueGraph::ParsedScript::internTimelineName(string_view name) {
+    if (auto* existing = timelineNameIndex.search(name)) {
+        return *existing;
+    }
+    timelineNames.push(string(name));
+    timelineNameIndex.insert(string(name), timelineNames.length() - 1);
+    return timelineNames.length() - 1;
+}
+
+// Parse one script into out without touching the graph, so several files can
+// be parsed at once. Diagnostics and parser exceptions are kept for mergeScript.
+// Paged: nodes are headers (ID, byte range, choice count) and their other
+// lines are left for pageIn.
+void DialogueGraph::parseScript(const string& filename, ParsedScript& out, bool paged) {
+    // Map the whole script; every line and field below is a view into it
+    ScriptFile script;
+    if (!script.open(filename)) {
+        return;
+    }
+    out.opened = true;
+    out.paged = paged;
 
-    string line;
+    string_view text = script.contents();
+    const char* cursor = text.data();
+    const char* end = cursor + text.size();
     NodeInfo* currentNode = nullptr;
+    int lineNumber = 0;
 
-    while (getline(file, line)) {
-        line = trim(line);
+    // A paged node's range ends where the next NODE: line (or the file) starts
+    auto closePage = [&](const char* pageEnd) {
+        if (paged && currentNode) {
+            currentNode->page.length = static_cast<uint32_t>(pageEnd - text.data() - currentNode->page.offset);
+        }
+    };
 
-        // Skip empty lines and comments
-        if (line.empty() || line[0] == '#') continue;
+    try {
+        while (cursor < end) {
+            // memchr is vectorized by the C library, so line scanning runs many bytes per step
+            const char* lineStart = cursor;
+            const char* newline = static_cast<const char*>(memchr(cursor, '\n', static_cast<size_t>(end - cursor)));
+            const char* lineEnd = newline ? newline : end;
+            string_view line = trimView(string_view(cursor, static_cast<size_t>(lineEnd - cursor)));
+            cursor = lineEnd + 1;
+            ++lineNumber;
+
+            // Skip empty lines and comments
+            if (line.empty() || line[0] == '#') continue;
+
+            if (line.starts_with("NODE:")) {
+                closePage(lineStart);
+                // Create new node for parsing, remembering its line for duplicate reports
+                currentNode = new NodeInfo();
+                out.nodes.push(ParsedNode{currentNode, lineNumber});  // Owned until merged
+                currentNode->nodeId = string(trimView(line.substr(5)));
+                if (paged) {
+                    currentNode->page.offset = static_cast<uint64_t>(lineStart - text.data());
+                }
+            }
+            else if (line.starts_with("ROOT:")) {
+                out.rootNodeId = string(trimView(line.substr(5)));
+                out.hasRoot = true;
+            }
+            else if (currentNode && paged) {
+                currentNode->page.choiceCount += line.starts_with("CHOICE:");
+            }
+            else if (currentNode) {
+                parseNodeLine(line, *currentNode, out, filename, lineNumber);
+            }
+        }
+        closePage(end);
+    } catch (...) {
+        out.failure = current_exception();
+    }
+}
 
-        if (line.rfind("NODE:", 0) == 0) {
-            // Insert previous node into this file's hash table
-            if (currentNode) {
-                currentFileNodes->insert(currentNode->nodeId, currentNode);
+// SPEAKER:, MSG: and CHOICE: lines of the node being parsed; others are ignored
+void DialogueGraph::parseNodeLine(string_view line, NodeInfo& node, ParsedScript& script, const string& filename, int lineNumber) {
+    if (line.starts_with("SPEAKER:")) {
+        node.speaker = string(trimView(line.substr(8)));
+    }
+    else if (line.starts_with("MSG:")) {
+        node.message = string(trimView(line.substr(4)));
+    }
+    else if (line.starts_with("CHOICE:")) {
+        // Parsed straight into the node's list
+        string error;
+        if (!parseChoice(line.substr(7), node.choices.emplace(), script, error)) {
+            script.diagnostics += filename + ":" + to_string(lineNumber) + ": " + error + " (choice disabled)\n";
+        }
+    }
+}
+
+// Intern a parsed script's item specs into the graph's table; the result maps
+// the script's ACT_ITEM operands onto the graph's
+ArrayList<int> DialogueGraph::adoptItemSpecs(const ParsedScript& parsed) const {
+    ArrayList<int> itemRemap;
+    itemRemap.reserve(parsed.itemSpecs.length());
+    for (int i = 0; i < parsed.itemSpecs.length(); ++i) {
+        itemRemap.push(internItemSpec(parsed.itemSpecs[i], parsed.itemDefinitions[i]));
+    }
+    return itemRemap;
+}
+
+ArrayList<int> DialogueGraph::adoptTimelineNames(const ParsedScript& parsed) const {
+    ArrayList<int> timelineRemap;
+    timelineRemap.reserve(parsed.timelineNames.length());
+    for (const string& name : parsed.timelineNames) {
+        timelineRemap.push(internTimelineName(name));
+    }
+    return timelineRemap;
+}
+
+void DialogueGraph::remapOperands(NodeInfo& node, const ArrayList<int>& itemRemap, const ArrayList<int>& timelineRemap) {
+    for (ChoiceInfo& choice : node.choices) {
+        for (ActionOp& op : choice.program) {
+            if (op.opcode == ACT_ITEM) {
+                op.operand = itemRemap[op.operand];
+            } else if (op.opcode == ACT_TIMELINE) {
+                op.operand = timelineRemap[op.operand];
             }
+        }
+    }
+}
+
+// Apply a parsed script to the graph: files merge in load order, which is
+// what gives earlier files precedence
+bool DialogueGraph::mergeScript(const string& filename, ParsedScript& parsed, bool isFirstFile) {
+    cerr << parsed.diagnostics;
+    if (parsed.failure) {
+        rethrow_exception(parsed.failure);
+    }
+    if (!parsed.opened) {
+        cerr << "Failed to open dialogue file: " << filename << endl;
+        return false;
+    }
 
-            // Create new node for parsing
-            currentNode = new NodeInfo();
-            currentNode->nodeId = trim(line.substr(5));
-            allNodeInfos.push(currentNode);  // Track for cleanup
+    // Track this file for diagnostics; its position sets its precedence
+    int fileIndex = allFiles.length();
+    allFiles.push(filename);
+    int nodesBefore = nodeIndex.size();
+    if (isFirstFile && parsed.hasRoot) {
+        rootNodeId = parsed.rootNodeId;
+    }
+
+    // Rebase item and timeline operands from the file's tables onto the graph's
+    ArrayList<int> itemRemap = adoptItemSpecs(parsed);
+    ArrayList<int> timelineRemap = adoptTimelineNames(parsed);
+
+    for (const ParsedNode& node : parsed.nodes) {
+        remapOperands(*node.info, itemRemap, timelineRemap);
+        if (parsed.paged) {
+            node.info->page.file = fileIndex; // Headers learn their file here
         }
-        else if (line.rfind("SPEAKER:", 0) == 0 && currentNode) {
-            currentNode->speaker = trim(line.substr(8));
+        allNodeInfos.push(node.info);  // Track for cleanup
+        indexNode(node.info, fileIndex, node.line);
+    }
+    parsed.nodes.clear(); // Ownership moved to the graph
+
+    // Choices that found no target before this file may find one now
+    if (!isFirstFile && nodeIndex.size() > nodesBefore) {
+        relinkMissingTargets();
+    }
+    return true;
+}
+
+// Usually a half-typed edit: the game keeps playing on the previous version
+void DialogueGraph::reportReloadFailure(const string& filename, const exception_ptr& failure) {
+    try {
+        rethrow_exception(failure);
+    } catch (const exception& e) {
+        cerr << filename << ": reload failed (" << e.what() << "), keeping previous version" << endl;
+    } catch (...) {
+        cerr << filename << ": reload failed, keeping previous version" << endl;
+    }
+}
+
+bool DialogueGraph::reloadFile(const string& filename) {
+    if (image.isOpen()) {
+        cerr << "Cannot reload " << filename << ": graph was loaded from a compiled image" << endl;
+        return false;
+    }
+
+    int fileIndex = -1;
+    filesystem::path target = filesystem::path(filename).lexically_normal();
+    for (int i = 0; i < allFiles.length() && fileIndex < 0; ++i) {
+        if (filesystem::path(allFiles[i]).lexically_normal() == target) {
+            fileIndex = i;
         }
-        else if (line.rfind("MSG:", 0) == 0 && currentNode) {
-            currentNode->message = trim(line.substr(4));
+    }
+    if (fileIndex < 0) {
+        // New script: lowest precedence. Checked before merging, which would rethrow
+        ParsedScript parsed;
+        parseScript(filename, parsed, pagedLoading);
+        if (parsed.failure) {
+            cerr << parsed.diagnostics;
+            reportReloadFailure(filename, parsed.failure);
+            return false;
         }
-        else if (line.rfind("CHOICE:", 0) == 0 && currentNode) {
-            ChoiceInfo choice = parseChoice(line.substr(7));
-            currentNode->choices.push(choice); // Add choice to node
+        bool loaded = mergeScript(filename, parsed, false);
+        if (loaded) {
+            ++reloadCount;
         }
-        else if (line.rfind("ROOT:", 0) == 0 && isFirstFile) {
-            rootNodeId = trim(line.substr(5));
+        return loaded;
+    }
+    for (const NodeInfo* info : allNodeInfos) {
+        if (info->page.file == fileIndex) {
+            cerr << "Cannot reload " << filename << ": it was loaded paged, nodes are read back from the old text" << endl;
+            return false;
         }
     }
 
-    // Save last node
-    if (currentNode) {
-        currentFileNodes->insert(currentNode->nodeId, currentNode);
+    ParsedScript parsed;
+    parseScript(filename, parsed, false);
+    cerr << parsed.diagnostics;
+    if (parsed.failure) {
+        reportReloadFailure(filename, parsed.failure);
+        return false;
+    }
+    if (!parsed.opened) {
+        cerr << "Failed to open dialogue file: " << filename << endl;
+        return false;
+    }
+
+    ArrayList<int> itemRemap = adoptItemSpecs(parsed);
+    ArrayList<int> timelineRemap = adoptTimelineNames(parsed);
+
+    // Diff the new definitions against the ones this file currently owns
+    HashTable<string_view, NodeInfo*> fresh;   // Keys view the new NodeInfos
+    ArrayList<NodeInfo*> discarded;            // Deleted once fresh is done with them
+    int added = 0, changed = 0, unchanged = 0, removed = 0;
+    for (const ParsedNode& node : parsed.nodes) {
+        NodeInfo* info = node.info;
+        remapOperands(*info, itemRemap, timelineRemap);
+
+        if (fresh.search(string_view(info->nodeId))) {
+            cerr << filename << ":" << node.line << ": duplicate node '" << info->nodeId << "' ignored" << endl;
+            discarded.push(info);
+            continue;
+        }
+        fresh.insert(string_view(info->nodeId), info);
+
+        NodeLocation* current = nodeIndex.search(string_view(info->nodeId));
+        if (!current) {
+            allNodeInfos.push(info);
+            indexNode(info, fileIndex, node.line);
+            ++added;
+        }
+        else if (current->fileIndex < fileIndex) {
+            // An earlier file still owns this ID
+            cerr << filename << ":" << node.line << ": duplicate node '" << info->nodeId << "' ignored (first defined at "
+                 << allFiles[current->fileIndex] << ":" << current->line << ")" << endl;
+            discarded.push(info);
+        }
+        else if (current->fileIndex == fileIndex && sameContent(*current->info, *info)) {
+            current->line = node.line;
+            discarded.push(info);
+            ++unchanged;
+        }
+        else {
+            // Edited here, or this file now outranks a later definition
+            allNodeInfos.push(info);
+            replaceNode(*current, info, fileIndex, node.line);
+            ++changed;
+        }
+    }
+    parsed.nodes.clear(); // Every node was adopted or discarded above
+
+    // IDs this file owned that its new version no longer defines
+    ArrayList<NodeInfo*> dropped;
+    for (NodeInfo* info : allNodeInfos) {
+        const NodeLocation* location = nodeIndex.search(string_view(info->nodeId));
+        if (location && location->info == info && location->fileIndex == fileIndex &&
+            !fresh.search(string_view(info->nodeId))) {
+            dropped.push(info);
+        }
+    }
+    for (NodeInfo* info : dropped) {
+        nodeIndex.remove(string_view(info->nodeId));
+        ++removed;
+    }
+    for (NodeInfo* info : discarded) {
+        delete info;
     }
 
-    file.close();
+    if (added > 0) {
+        relinkMissingTargets();
+    }
+    if (added + changed + removed > 0) {
+        ++reloadCount;
+    }
+    cout << "Reloaded " << filename << ": " << changed << " changed, " << added << " added, "
+         << removed << " removed, " << unchanged << " unchanged" << endl;
     return true;
 }
 
-NTree<Dialogue, MAX_CHOICES>* DialogueGraph::buildNode(const string& nodeId) {
-    // Check if node already built (cache lookup)
-    auto* existing = builtNodes.search(nodeId);
-    if (existing) {
-        return *existing; // Return cached tree node
-    }
-
-    // Find node data across all loaded files (nested hash table search)
-    NodeInfo* data = nullptr;
-    auto fileIt = allFiles.getIterator();
-    auto endFileIt = fileIt.end();
-    while (fileIt != endFileIt) {
-        // Get inner hash table for this file
-        auto** fileNodes = fileNodeData.search(fileIt.getCurrent()->getValue());
-        if (fileNodes) {
-            // Search for node in this file's hash table
-            auto* dataPtr = (*fileNodes)->search(nodeId);
-            if (dataPtr) {
-                data = *dataPtr;
-                break;
-            }
-        }
-        ++fileIt;
+// Point the index (and the compiled node, if built) at a new definition. The
+// node keeps its index and gets a fresh choice range at the end of edges;
+// the old NodeInfo and choice range stay alive for views built before the reload.
+void DialogueGraph::replaceNode(const NodeLocation& current, NodeInfo* replacement, int fileIndex, int line) {
+    string_view oldKey = current.info->nodeId;   // current is invalidated by remove
+    nodeIndex.remove(oldKey);
+    nodeIndex.insert(string_view(replacement->nodeId), NodeLocation{replacement, fileIndex, line});
+
+    int* built = builtNodes.search(string_view(replacement->nodeId));
+    if (!built) {
+        return;
     }
+    CompiledNode& node = nodes[*built];
+    node.info = replacement;
+    node.firstChoice = edges.length();
+    node.choiceCount = replacement->choices.length();
+    for (ChoiceInfo& choice : replacement->choices) {
+        // Targets resolve on first use, whatever the build mode
+        edges.push(CompiledChoice{choice.targetNodeId.empty() ? NO_TARGET : UNRESOLVED, &choice});
+    }
+}
 
-    if (!data) {
-        cerr << "Node not found: " << nodeId << endl;
-        return nullptr;
+bool DialogueGraph::sameContent(const NodeInfo& a, const NodeInfo& b) {
+    if (a.speaker != b.speaker || a.message != b.message || a.choices.length() != b.choices.length()) {
+        return false;
     }
+    auto otherIt = b.choices.begin();
+    for (const ChoiceInfo& choice : a.choices) {
+        const ChoiceInfo& other = *otherIt;
+        ++otherIt;
+        if (choice.text != other.text || choice.targetNodeId != other.targetNodeId ||
+            choice.condition.getSource() != other.condition.getSource() ||
+            choice.program.length() != other.program.length()) {
+            return false;
+        }
+        for (int i = 0; i < choice.program.length(); ++i) {
+            const ActionOp& op = choice.program[i];
+            const ActionOp& otherOp = other.program[i];
+            // A GOTO operand is a link-time index, not content
+            if (op.opcode != otherOp.opcode || (op.opcode != ACT_GOTO && op.operand != otherOp.operand)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
 
-    // Create dialogue data for tree node
-    Dialogue dialogue;
-    dialogue.speaker = data->speaker;
-    dialogue.message = data->message;
+bool DialogueGraph::loadFiles(const List<string>& filenames) {
+    clearSources();
+    clearCompiled();
+    image.close();
 
-    // Create new N-ary tree node with dialogue data
-    auto* node = new NTree<Dialogue, MAX_CHOICES>(dialogue);
-    builtNodes.insert(nodeId, node); // Cache this built node
-    allTreeNodes.push(node); // Track for cleanup
+    ArrayList<const string*> names;
+    for (const string& filename : filenames) {
+        names.push(&filename);
+    }
+    int fileCount = names.length();
 
-    // Iterate through choices and build child nodes recursively
-    auto choiceIt = data->choices.getIterator();
-    auto endIt = choiceIt.end();
+    ArrayList<ParsedScript> parsed;
+    parsed.reserve(fileCount);
+    for (int i = 0; i < fileCount; ++i) {
+        parsed.emplace();
+    }
 
-    while (choiceIt != endIt) {
-        ChoiceInfo& choiceInfo = choiceIt.getCurrent()->getValue();
+    // Thread pool for this batch: workers claim the next unparsed file, so a
+    // few large files do not leave other threads idle. The calling thread works too.
+    atomic<int> nextFile(0);
+    auto worker = [&]() {
+        for (int i = nextFile++; i < fileCount; i = nextFile++) {
+            parseScript(*names[i], parsed[i], pagedLoading);
+        }
+    };
+    int threadCount = min(fileCount, max(1, static_cast<int>(thread::hardware_concurrency())));
+    ArrayList<thread> workers;
+    for (int i = 1; i < threadCount; ++i) {
+        workers.emplace(worker);
+    }
+    worker();
+    for (thread& workerThread : workers) {
+        workerThread.join();
+    }
 
-        // Recursively build child nodes for branching narrative
-        NTree<Dialogue, MAX_CHOICES>* targetNode = nullptr;
-        if (!choiceInfo.targetNodeId.empty()) {
-            targetNode = buildNode(choiceInfo.targetNodeId);
+    // Merge on this thread in list order: same result as sequential loading
+    for (int i = 0; i < fileCount; ++i) {
+        if (!mergeScript(*names[i], parsed[i], i == 0)) {
+            return false;
         }
+    }
+    return fileCount > 0;
+}
 
-        Choice choice;
-        choice.text = choiceInfo.text;
-        choice.action = createAction(choiceInfo, targetNode);
+bool DialogueGraph::loadDirectory(const string& directory) {
+    // Every .txt script in the directory, in name order
+    List<string> filenames;
+    ArrayList<string> found;
+    error_code error;
+    for (const auto& entry : filesystem::directory_iterator(directory, error)) {
+        if (entry.is_regular_file() && entry.path().extension() == ".txt") {
+            found.push(entry.path().string());
+        }
+    }
+    if (error) {
+        cerr << "Failed to read dialogue directory " << directory << ": " << error.message() << endl;
+        return false;
+    }
+    sort(found.getData(), found.getData() + found.length());
+    for (string& filename : found) {
+        filenames.push(std::move(filename));
+    }
+    return loadFiles(filenames);
+}
 
-        node->getKey().choices.push(choice); // Add choice to dialogue
+bool DialogueGraph::loadManifest(const string& manifestFile) {
+    ScriptFile manifest;
+    if (!manifest.open(manifestFile)) {
+        cerr << "Failed to open dialogue manifest: " << manifestFile << endl;
+        return false;
+    }
 
-        ++choiceIt;
+    // One script path per line, relative to the manifest; '#' starts a comment
+    filesystem::path base = filesystem::path(manifestFile).parent_path();
+    List<string> filenames;
+    string_view text = manifest.contents();
+    size_t start = 0;
+    while (start < text.size()) {
+        size_t end = text.find('\n', start);
+        if (end == string_view::npos) {
+            end = text.size();
+        }
+        string_view line = trimView(text.substr(start, end - start));
+        start = end + 1;
+        if (!line.empty() && line[0] != '#') {
+            filenames.push((base / filesystem::path(line)).string());
+        }
     }
+    return loadFiles(filenames);
+}
 
-    return node;
+// HashTable data structure utilization: add a definition to the global index
+// unless an earlier one owns the ID
+void DialogueGraph::indexNode(NodeInfo* node, int fileIndex, int line) {
+    if (const NodeLocation* existing = nodeIndex.search(string_view(node->nodeId))) {
+        cerr << allFiles[fileIndex] << ":" << line << ": duplicate node '" << node->nodeId
+             << "' ignored (first defined at " << allFiles[existing->fileIndex] << ":" << existing->line << ")" << endl;
+        return;
+    }
+    nodeIndex.insert(string_view(node->nodeId), NodeLocation{node, fileIndex, line});
 }
 
-function<void()> DialogueGraph::createAction(const ChoiceInfo& choiceInfo, NTree<Dialogue, MAX_CHOICES>* targetNode) {
-    // Lambda captures choice data and creates callable action
-    return [this, choiceInfo, targetNode]() {
-        // Check all conditions before executing actions
-        auto condIt = const_cast<List<string>&>(choiceInfo.condition).getIterator();
-        auto condEnd = const_cast<List<string>&>(choiceInfo.condition).getIterator().end();
-        while (condIt != condEnd) {
-            if (!evaluateCondition(condIt.getCurrent()->getValue())) {
-                cout << "Condition not met: " << condIt.getCurrent()->getValue() << endl;
-                return; // Condition failed - abort action
+// Compiled choices whose target ID was missing go back to UNRESOLVED, so an
+// additional file can supply targets without rebuilding the graph
+void DialogueGraph::relinkMissingTargets() {
+    for (CompiledChoice& edge : edges) {
+        if (edge.target == NO_TARGET && edge.info && !edge.info->targetNodeId.empty() &&
+            nodeIndex.search(string_view(edge.info->targetNodeId))) {
+            edge.target = UNRESOLVED;
+            edge.info->program.getLast().operand = UNRESOLVED;
+        }
+    }
+
+    // Paged choices keep their target IDs in the script, so read those nodes back
+    for (int i = 0; i < nodes.length(); ++i) {
+        const CompiledNode& node = nodes[i];
+        if (!node.info || !node.info->isPaged()) {
+            continue;
+        }
+        for (int edgeIndex = node.firstChoice; edgeIndex < node.firstChoice + node.choiceCount; ++edgeIndex) {
+            if (edges[edgeIndex].target != NO_TARGET) {
+                continue;
+            }
+            ChoiceInfo* choiceInfo = choiceAt(i, edgeIndex);
+            if (!choiceInfo->targetNodeId.empty() && nodeIndex.search(string_view(choiceInfo->targetNodeId))) {
+                edges[edgeIndex].target = UNRESOLVED;
+                choiceInfo->program.getLast().operand = UNRESOLVED; // The cached copy may be patched
             }
-            ++condIt;
         }
+    }
+}
+
+// Compile a node and, unless building lazily, everything reachable from it
+int DialogueGraph::buildNode(string_view nodeId) {
+    // Check if node already built (cache lookup)
+    auto* existing = builtNodes.search(nodeId);
+    if (existing) {
+        return *existing; // Return compiled node index
+    }
 
-        // Execute all actions sequentially (gold, items, XP, etc.)
-        auto actionIt = const_cast<List<Action>&>(choiceInfo.actions).getIterator();
-        auto endIt = actionIt.end();
+    int index = compileNode(nodeId);
+    if (index != NO_TARGET && !lazyBuild) {
+        linkReachable(index);
+    }
+    return index;
+}
 
-        while (actionIt != endIt) {
-            Action& action = actionIt.getCurrent()->getValue();
-            executeAction(action); // Modify player state
-            ++actionIt;
+// Append one node record with its choice range; targets start UNRESOLVED
+int DialogueGraph::compileNode(string_view nodeId) {
+    // One probe of the global index, however many files are loaded
+    const NodeLocation* location = nodeIndex.search(nodeId);
+    if (!location) {
+        cerr << "Node not found: " << nodeId << endl;
+        return NO_TARGET;
+    }
+    NodeInfo* data = location->info;
+
+    int index = nodes.length();
+    builtNodes.insert(string(nodeId), index); // Cache this built node (the only key copy)
+    if (data->isPaged()) {
+        // The header has no choices to look at: every target resolves on first use
+        nodes.push(CompiledNode{edges.length(), data->page.choiceCount, data});
+        for (int i = 0; i < data->page.choiceCount; ++i) {
+            edges.push(CompiledChoice{UNRESOLVED, nullptr});
         }
+        return index;
+    }
+    nodes.push(CompiledNode{edges.length(), data->choices.length(), data});
+
+    auto choiceIt = data->choices.getIterator();
+    auto endIt = choiceIt.end();
+    while (choiceIt != endIt) {
+        ChoiceInfo& choiceInfo = choiceIt.getCurrent()->getValue();
+        edges.push(CompiledChoice{choiceInfo.targetNodeId.empty() ? NO_TARGET : UNRESOLVED, &choiceInfo});
+        ++choiceIt;
+    }
+
+    return index;
+}
 
-        // Navigate to target node in dialogue tree
-        if (targetNode && onDialogueStart) {
-            onDialogueStart(targetNode, choiceInfo.targetNodeId);
+// Target node index of a choice, compiling the target on first use.
+// compileNode never reads a paged node back, so choiceInfo stays valid.
+int DialogueGraph::resolveTarget(int nodeIndex, int edgeIndex) {
+    if (edges[edgeIndex].target == UNRESOLVED) {
+        ChoiceInfo* choiceInfo = choiceAt(nodeIndex, edgeIndex);
+        const string& targetNodeId = choiceInfo->targetNodeId;
+        int target = NO_TARGET;   // Only paged choices get here without a target
+        if (!targetNodeId.empty()) {
+            auto* existing = builtNodes.search(targetNodeId);
+            target = existing ? *existing : compileNode(targetNodeId);
+            choiceInfo->program.getLast().operand = target; // Patch the choice's GOTO
         }
-    };
+        edges[edgeIndex].target = target; // Re-index: compileNode may grow the array
+    }
+    return edges[edgeIndex].target;
 }
 
-void DialogueGraph::executeAction(const Action& action) {
-    switch (action.type) {
-        case GOLD:
-            if (action.intParam > 0) {
-                playerRef->getInventory().addGold(action.intParam);
-            } else {
-                playerRef->getInventory().spendGold(-action.intParam);
+// Queue data structure utilization: breadth-first worklist over unlinked nodes.
+// Each node is compiled once (builtNodes), so cycles terminate and long chains
+// use no native stack.
+void DialogueGraph::linkReachable(int startIndex) {
+    Queue<int> worklist;
+    worklist.enqueue(startIndex);
+    int linked = 0;
+
+    while (!worklist.isEmpty()) {
+        int index = worklist.dequeue();
+        int firstChoice = nodes[index].firstChoice;
+        int choiceEnd = firstChoice + nodes[index].choiceCount;
+
+        for (int i = firstChoice; i < choiceEnd; ++i) {
+            int nodesBefore = nodes.length();
+            resolveTarget(index, i);
+            if (nodes.length() > nodesBefore) {
+                worklist.enqueue(nodesBefore); // Newly compiled target
             }
-            break;
+        }
 
-        case ITEM: {
-            Item item = createItemFromString(action.stringParam);
-            item.value = action.intParam;
-            playerRef->pickupItem(item);
-            break;
+        if (++linked % PROGRESS_INTERVAL == 0 && buildProgress) {
+            if (!buildProgress(nodes.length(), worklist.size())) {
+                return; // Caller's budget is spent: remaining targets resolve on first use
+            }
         }
+    }
 
-        case XP:
-            playerRef->getStats().gainExperience(action.intParam);
-            break;
+    if (buildProgress) {
+        buildProgress(nodes.length(), 0);
+    }
+}
 
-        case HEALTH:
-            if (action.intParam > 0) {
-                playerRef->getStats().heal(action.intParam);
-            } else {
-                playerRef->getStats().takeDamage(-action.intParam);
+// Check a choice's conditions, then run its program
+void DialogueGraph::fireChoice(int nodeIndex, int edgeIndex) {
+    ChoiceInfo* choiceInfo = choiceAt(nodeIndex, edgeIndex);
+    if (!choiceInfo) {
+        // Image-backed choice: condition and program are image records
+        const ImageChoice& record = image.getChoice(edgeIndex);
+        bool conditionMet = ConditionProgram::run(image.getConditionOps(record), static_cast<int>(record.conditionOpCount),
+                                                  *playerRef, [this](int32_t index) { return image.getConditionName(index); });
+        if (!conditionMet) {
+            cout << "Condition not met: " << image.getString(record.conditionSource) << endl;
+            return;
+        }
+        runProgram(image.getActionOps(record), static_cast<int>(record.actionOpCount), nodeIndex, edgeIndex);
+        return;
+    }
+
+    // Check the compiled condition before executing actions
+    if (!choiceInfo->condition.evaluate(*playerRef)) {
+        cout << "Condition not met: " << choiceInfo->condition.getSource() << endl;
+        return; // Condition failed - abort action
+    }
+    runProgram(choiceInfo->program.getData(), choiceInfo->program.length(), nodeIndex, edgeIndex);
+}
+
+// Action interpreter: effects modify player state, GOTO shows the target node.
+// Programs are never modified while running, except for a text graph's GOTO
+// operand being patched by resolveTarget. Showing the target can evict a paged
+// program from the page cache, so nothing runs after GOTO.
+void DialogueGraph::runProgram(const ActionOp* program, int length, int nodeIndex, int edgeIndex) {
+    for (int i = 0; i < length; ++i) {
+        const ActionOp& op = program[i];
+        switch (op.opcode) {
+            case ACT_GOLD: applyEffect(GOLD, op.operand, {}); break;
+            case ACT_ITEM: applyEffect(ITEM, 0, itemPrototypes[op.operand]); break;
+            case ACT_XP: applyEffect(XP, op.operand, {}); break;
+            case ACT_HEALTH: applyEffect(HEALTH, op.operand, {}); break;
+            case ACT_MANA: applyEffect(MANA, op.operand, {}); break;
+            case ACT_TIMELINE:
+                if (onTimelineStart) {
+                    onTimelineStart(image.isOpen() ? image.getTimelineName(op.operand) : string_view(timelineNames[op.operand]));
+                }
+                break;
+            case ACT_GOTO: {
+                // Index navigation, no string hashing once resolved
+                int target = op.operand == UNRESOLVED ? resolveTarget(nodeIndex, edgeIndex) : op.operand;
+                if (target != NO_TARGET && onDialogueStart) {
+                    onDialogueStart(showNode(target), getNodeId(target));
+                }
+                return;
             }
-            break;
+            default: return;
+        }
+    }
+}
 
-        case MANA:
-            playerRef->getStats().restoreMana(action.intParam);
-            break;
+bool DialogueGraph::loadCompiled(const string& imageFile, const List<string>& scriptFiles) {
+    uint64_t sourceHash = 0;
+    bool haveSources = !scriptFiles.isEmpty() && DialogueImage::hashSources(scriptFiles, sourceHash);
 
-        case END_DIALOGUE:
-            // Handle dialogue end
-            break;
+    clearSources();
+    clearCompiled();
+    if (image.open(imageFile)) {
+        if (!haveSources || image.getSourceHash() == sourceHash) {
+            if (useImage()) {
+                return true;
+            }
+        } else {
+            cout << "Compiled dialogue image " << imageFile << " is stale, parsing scripts" << endl;
+        }
+        image.close();
     }
+
+    // Text fallback, parsed in parallel with sequential-loading precedence
+    return loadFiles(scriptFiles);
 }
 
-bool DialogueGraph::evaluateCondition(const string& condition) {
-    // Simple condition parser: "gold>=30", "level>5", "hasitem:Sword"
-    if (condition.rfind("gold>=", 0) == 0) {
-        int required = stoi(condition.substr(6));
-        return playerRef->getInventory().getGold() >= required;
+// Fill the compiled arrays from the open image: targets are already resolved,
+// so the only parsing is the item specs. False when a spec is malformed.
+bool DialogueGraph::useImage() {
+    int itemSpecCount = image.getItemSpecCount();
+    itemPrototypes.reserve(itemSpecCount);
+    for (int i = 0; i < itemSpecCount; ++i) {
+        try {
+            itemPrototypes.push(ItemRegistry::global().fromSpec(image.getItemSpec(i)));
+        } catch (const exception& e) {
+            cerr << "Compiled dialogue image has a bad item spec '" << image.getItemSpec(i)
+                 << "': " << e.what() << ", parsing scripts" << endl;
+            itemPrototypes.clear();
+            return false;
+        }
     }
-    else if (condition.rfind("gold>", 0) == 0) {
-        int required = stoi(condition.substr(5));
-        return playerRef->getInventory().getGold() > required;
+
+    int nodeCount = image.getNodeCount();
+    nodes.reserve(nodeCount);
+    for (int i = 0; i < nodeCount; ++i) {
+        const ImageNode& record = image.getNode(i);
+        nodes.push(CompiledNode{static_cast<int>(record.firstChoice), static_cast<int>(record.choiceCount), nullptr});
     }
-    else if (condition.rfind("level>=", 0) == 0) {
-        int required = stoi(condition.substr(7));
-        return playerRef->getStats().getLevel() >= required;
+
+    int choiceCount = image.getChoiceCount();
+    edges.reserve(choiceCount);
+    for (int i = 0; i < choiceCount; ++i) {
+        edges.push(CompiledChoice{image.getChoice(i).target, nullptr});
     }
-    else if (condition.rfind("mana>=", 0) == 0) {
-        int required = stoi(condition.substr(6));
-        return playerRef->getStats().getCurrentMana() >= required;
+    rootNode = image.getRootNode();
+    return true;
+}
+
+// Compile every indexed node (the root first) and resolve every choice. Targets
+// that do not exist become NO_TARGET without the runtime "Node not found"
+// message; returns the number of such choices.
+int DialogueGraph::compileAll() {
+    if (image.isOpen()) {
+        return 0; // Images are compiled with every target resolved
     }
-    else if (condition.rfind("hasitem:", 0) == 0) {
-        string itemName = condition.substr(8);
-        return playerRef->getInventory().hasItem(itemName);
+
+    if (rootNode == NO_TARGET && nodeIndex.search(string_view(rootNodeId))) {
+        const int* built = builtNodes.search(string_view(rootNodeId));
+        rootNode = built ? *built : compileNode(rootNodeId);
+    }
+    for (NodeInfo* info : allNodeInfos) {
+        const NodeLocation* location = nodeIndex.search(string_view(info->nodeId));
+        if (location && location->info == info && !builtNodes.search(string_view(info->nodeId))) {
+            compileNode(info->nodeId);
+        }
     }
 
-    return true;
+    // Every target is compiled now, so resolving never grows the arrays
+    int missing = 0;
+    for (int index = 0; index < nodes.length(); ++index) {
+        const CompiledNode& node = nodes[index];
+        for (int i = node.firstChoice; i < node.firstChoice + node.choiceCount; ++i) {
+            CompiledChoice& edge = edges[i];
+            if (edge.target >= 0) {
+                continue; // Resolved: no need to read a paged node back
+            }
+            ChoiceInfo* choiceInfo = choiceAt(index, i);
+            if (edge.target == UNRESOLVED) {
+                const int* target = builtNodes.search(string_view(choiceInfo->targetNodeId));
+                edge.target = target ? *target : NO_TARGET;
+                if (!choiceInfo->targetNodeId.empty()) {
+                    choiceInfo->program.getLast().operand = edge.target;
+                }
+            }
+            if (edge.target == NO_TARGET && !choiceInfo->targetNodeId.empty()) {
+                ++missing;
+            }
+        }
+    }
+    return missing;
 }
 
-Item DialogueGraph::createItemFromString(const string& itemStr) {
-    // Split string returns list of parts
-    List<string> parts = split(itemStr, ':');
-
-    string name = "Unknown";
-    ItemType type = ItemType::MISC;
-    int bonus = 0;
+string_view DialogueGraph::getChoiceText(int nodeIndex, int choice) const {
+    int edgeIndex = nodes[nodeIndex].firstChoice + choice;
+    const ChoiceInfo* info = choiceAt(nodeIndex, edgeIndex);
+    return info ? string_view(info->text) : image.getString(image.getChoice(edgeIndex).text);
+}
 
-    // Parse item components from list (name:type:bonus)
-    auto it = parts.getIterator();
-    auto endIt = it.end();
-    int index = 0;
+string_view DialogueGraph::getTargetId(int nodeIndex, int choice) const {
+    int edgeIndex = nodes[nodeIndex].firstChoice + choice;
+    const ChoiceInfo* info = choiceAt(nodeIndex, edgeIndex);
+    if (info) {
+        return info->targetNodeId;
+    }
+    int target = edges[edgeIndex].target;
+    return target == NO_TARGET ? string_view() : getNodeId(target);
+}
 
-    while (it != endIt) {
-        string part = trim(it.getCurrent()->getValue());
+const ConditionProgram* DialogueGraph::getCondition(int nodeIndex, int choice) const {
+    const ChoiceInfo* info = choiceAt(nodeIndex, nodes[nodeIndex].firstChoice + choice);
+    return info ? &info->condition : nullptr;
+}
 
-        if (index == 0) {
-            name = part;
-        }
-        else if (index == 1) {
-            type = stringToItemType(part);
+bool DialogueGraph::saveImage(const string& imageFile, uint64_t sourceHash) {
+    if (image.isOpen()) {
+        cerr << "Graph was loaded from a compiled image; load scripts to recompile" << endl;
+        return false;
+    }
+    for (const NodeInfo* info : allNodeInfos) {
+        if (info->isPaged()) {
+            cerr << "Graph was loaded paged; load scripts without a page budget to compile an image" << endl;
+            return false;
         }
-        else if (index == 2) {
-            bonus = stoi(part);
+    }
+
+    int missing = compileAll();
+    if (missing > 0) {
+        cerr << "Warning: " << missing << " choice target(s) not found; those choices end the dialogue" << endl;
+    }
+
+    // String pool with interning (speaker names and the like repeat a lot)
+    string pool;
+    HashTable<string, ImageStringRef> interned;
+    auto intern = [&](const string& text) {
+        if (auto* existing = interned.search(text)) {
+            return *existing;
         }
+        ImageStringRef ref{static_cast<uint32_t>(pool.size()), static_cast<uint32_t>(text.size())};
+        pool += text;
+        interned.insert(text, ref);
+        return ref;
+    };
 
-        ++it;
-        ++index;
+    ArrayList<ImageNode> nodeRecords;
+    ArrayList<ImageChoice> choiceRecords;
+    ArrayList<ActionOp> actionOps;
+    ArrayList<ImageStringRef> itemSpecRecords;
+    ArrayList<ConditionOp> conditionOps;
+    ArrayList<ImageStringRef> conditionNames;
+    ArrayList<ImageStringRef> timelineNameRecords;
+    ArrayList<uint32_t> sortedNodes;
+
+    // Choices are written node by node: a node replaced by a reload leaves its
+    // old range in edges, referenced by no node, and that range is dropped here
+    nodeRecords.reserve(nodes.length());
+    choiceRecords.reserve(edges.length());
+    for (int i = 0; i < nodes.length(); ++i) {
+        const CompiledNode& node = nodes[i];
+        nodeRecords.push(ImageNode{intern(node.info->nodeId), intern(node.info->speaker), intern(node.info->message),
+                                   static_cast<uint32_t>(choiceRecords.length()), static_cast<uint32_t>(node.choiceCount)});
+        sortedNodes.push(static_cast<uint32_t>(i));
+
+        for (int edgeIndex = node.firstChoice; edgeIndex < node.firstChoice + node.choiceCount; ++edgeIndex) {
+            const ChoiceInfo& info = *edges[edgeIndex].info;
+            const ArrayList<ConditionOp>& code = info.condition.getCode();
+            ImageChoice record{intern(info.text), edges[edgeIndex].target,
+                               static_cast<uint32_t>(actionOps.length()), static_cast<uint32_t>(info.program.length()),
+                               intern(info.condition.getSource()),
+                               static_cast<uint32_t>(conditionOps.length()), static_cast<uint32_t>(code.length())};
+            for (const ActionOp& op : info.program) {
+                actionOps.push(op); // ITEM/TIMELINE operands already index the graph's tables; GOTOs were resolved above
+            }
+
+            // Item-name operands are rebased onto the image-wide name table
+            int nameBase = conditionNames.length();
+            for (const string& name : info.condition.getItemNames()) {
+                conditionNames.push(intern(name));
+            }
+            for (ConditionOp op : code) {
+                if (op.opcode == COND_HAS_ITEM) {
+                    op.operand += nameBase;
+                }
+                conditionOps.push(op);
+            }
+            choiceRecords.push(record);
+        }
     }
 
-    // Create item with parsed data
-    Item item(name, type, bonus);
+    itemSpecRecords.reserve(itemSpecs.length());
+    for (const string& itemSpec : itemSpecs) {
+        itemSpecRecords.push(intern(itemSpec));
+    }
+    timelineNameRecords.reserve(timelineNames.length());
+    for (const string& name : timelineNames) {
+        timelineNameRecords.push(intern(name));
+    }
 
-    if (type == ItemType::WEAPON) {
-        item.attackBonus = bonus;
+    if (pool.size() > UINT32_MAX) {
+        cerr << "Dialogue image string pool exceeds 4 GB" << endl;
+        return false;
     }
-    else if (type == ItemType::ARMOR) {
-        item.defenseBonus = bonus;
+
+    sort(sortedNodes.getData(), sortedNodes.getData() + sortedNodes.length(), [&](uint32_t a, uint32_t b) {
+        return nodes[static_cast<int>(a)].info->nodeId < nodes[static_cast<int>(b)].info->nodeId;
+    });
+
+    ImageHeader header{};
+    memcpy(header.magic, DialogueImageFormat::MAGIC, sizeof(header.magic));
+    header.version = DialogueImageFormat::VERSION;
+    header.endianTag = DialogueImageFormat::ENDIAN_TAG;
+    header.rootNode = rootNode;
+    header.sourceHash = sourceHash;
+    header.nodeCount = static_cast<uint32_t>(nodeRecords.length());
+    header.choiceCount = static_cast<uint32_t>(choiceRecords.length());
+    header.actionOpCount = static_cast<uint32_t>(actionOps.length());
+    header.itemSpecCount = static_cast<uint32_t>(itemSpecRecords.length());
+    header.conditionOpCount = static_cast<uint32_t>(conditionOps.length());
+    header.conditionNameCount = static_cast<uint32_t>(conditionNames.length());
+    header.timelineNameCount = static_cast<uint32_t>(timelineNameRecords.length());
+    header.stringPoolSize = static_cast<uint32_t>(pool.size());
+
+    // Written beside the target and renamed over it: a game that has the old
+    // image mapped keeps reading it intact, and a failed write leaves it in place
+    string tempFile = imageFile + ".tmp";
+    ofstream out(tempFile, ios::binary | ios::trunc);
+    if (!out.is_open()) {
+        cerr << "Failed to write dialogue image: " << tempFile << endl;
+        return false;
     }
-    else if (type == ItemType::POTION || type == ItemType::CONSUMABLE) {
-        item.healthRestore = bonus;
+    auto writeArray = [&out](const auto& list) {
+        out.write(reinterpret_cast<const char*>(list.getData()),
+                  static_cast<streamsize>(sizeof(*list.getData()) * static_cast<size_t>(list.length())));
+    };
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    writeArray(nodeRecords);
+    writeArray(choiceRecords);
+    writeArray(actionOps);
+    writeArray(itemSpecRecords);
+    writeArray(conditionOps);
+    writeArray(conditionNames);
+    writeArray(timelineNameRecords);
+    writeArray(sortedNodes);
+    out.write(pool.data(), static_cast<streamsize>(pool.size()));
+    out.close();
+
+    error_code error;
+    if (!out) {
+        cerr << "Failed to write dialogue image: " << tempFile << endl;
+    } else {
+        filesystem::rename(tempFile, imageFile, error);
+        if (!error) {
+            return true;
+        }
+        cerr << "Failed to replace dialogue image " << imageFile << ": " << error.message() << endl;
     }
+    filesystem::remove(tempFile, error);
+    return false;
+}
+
+void DialogueGraph::executeAction(const Action& action) {
+    const ItemPrototype* item = action.type == ITEM ? ItemRegistry::global().fromSpec(action.stringParam) : nullptr;
+    applyEffect(action.type, action.intParam, item);
+}
+
+// Shared by delayed actions and the choice program interpreter
+void DialogueGraph::applyEffect(Type type, int amount, const ItemPrototype* item) {
+    switch (type) {
+        case GOLD:
+            if (amount > 0) {
+                playerRef->getInventory().addGold(amount);
+            } else {
+                playerRef->getInventory().spendGold(-amount);
+            }
+            break;
+
+        case ITEM:
+            playerRef->pickupItem(Item(item, amount));
+            break;
+
+        case XP:
+            playerRef->getStats().gainExperience(amount);
+            break;
+
+        case HEALTH:
+            if (amount > 0) {
+                playerRef->getStats().heal(amount);
+            } else {
+                playerRef->getStats().takeDamage(-amount);
+            }
+            break;
+
+        case MANA:
+            playerRef->getStats().restoreMana(amount);
+            break;
 
-    return item;
+        case END_DIALOGUE:
+            // Handle dialogue end
+            break;
+    }
 }
 
-ItemType DialogueGraph::stringToItemType(const string& typeStr) {
-    if (typeStr == "WEAPON") return ItemType::WEAPON;
-    if (typeStr == "ARMOR") return ItemType::ARMOR;
-    if (typeStr == "POTION") return ItemType::POTION;
-    if (typeStr == "QUEST_ITEM") return ItemType::QUEST_ITEM;
-    if (typeStr == "CONSUMABLE") return ItemType::CONSUMABLE;
-    return ItemType::MISC;
+int DialogueGraph::internItemSpec(string_view itemSpec, const ItemPrototype& definition) const {
+    if (auto* existing = itemSpecIndex.search(itemSpec)) {
+        return *existing;
+    }
+    itemSpecs.push(string(itemSpec));
+    itemSpecIndex.insert(string(itemSpec), itemSpecs.length() - 1);
+    itemPrototypes.push(ItemRegistry::global().intern(definition));
+    return itemSpecs.length() - 1;
 }
 
-ChoiceInfo DialogueGraph::parseChoice(const string& choiceLine) {
-    ChoiceInfo info;
+int DialogueGraph::internTimelineName(string_view name) const {
+    if (auto* existing = timelineNameIndex.search(name)) {
+        return *existing;
+    }
+    timelineNames.push(string(name));
+    timelineNameIndex.insert(string(name), timelineNames.length() - 1);
+    return timelineNames.length() - 1;
+}
 
-    // Split choice line by '|' delimiter
-    List<string> parts = split(choiceLine, '|');
-    // Parse each part of the choice definition
-    auto it = parts.getIterator();
-    auto endIt = it.end();
+bool DialogueGraph::parseChoice(string_view choiceLine, ChoiceInfo& info, ParsedScript& script, string& error) {
+    const char* cursor = choiceLine.data();
+    const char* end = cursor + choiceLine.size();
     bool first = true;
+    string_view rejected;
 
-    while (it != endIt) {
-        string part = trim(it.getCurrent()->getValue());
+    // Walk the '|'-delimited parts in place (memchr scan, no part list)
+    while (cursor < end) {
+        const char* bar = static_cast<const char*>(memchr(cursor, '|', static_cast<size_t>(end - cursor)));
+        const char* partEnd = bar ? bar : end;
+        string_view part = trimView(string_view(cursor, static_cast<size_t>(partEnd - cursor)));
+        cursor = partEnd + 1;
 
         if (first) {
-            info.text = part; // First part is always the choice text
+            info.text = string(part); // First part is always the choice text
             first = false;
         }
-        else if (part.rfind("target:", 0) == 0) {
-            info.targetNodeId = trim(part.substr(7)); // Set target node ID
+        else if (part.starts_with("target:")) {
+            info.targetNodeId = string(trimView(part.substr(7))); // Set target node ID
         }
-        else if (part.rfind("gold:", 0) == 0) {
-            int amount = stoi(part.substr(5));
-            info.actions.push(Action(GOLD, amount)); // Add action to list
+        else if (part.starts_with("gold:")) {
+            info.program.push(ActionOp{ACT_GOLD, parseInt(part.substr(5))}); // Emit effect
         }
-        else if (part.rfind("item:", 0) == 0) {
-            string itemStr = part.substr(5);
-            info.actions.push(Action(ITEM, itemStr, 0)); // Add action to list
+        else if (part.starts_with("item:")) {
+            info.program.push(ActionOp{ACT_ITEM, script.internItemSpec(part.substr(5))}); // Emit effect
         }
-        else if (part.rfind("xp:", 0) == 0) {
-            int amount = stoi(part.substr(3));
-            info.actions.push(Action(XP, amount)); // Add action to list
+        else if (part.starts_with("xp:")) {
+            info.program.push(ActionOp{ACT_XP, parseInt(part.substr(3))}); // Emit effect
         }
-        else if (part.rfind("health:", 0) == 0) {
-            int amount = stoi(part.substr(7));
-            info.actions.push(Action(HEALTH, amount)); // Add action to list
+        else if (part.starts_with("health:")) {
+            info.program.push(ActionOp{ACT_HEALTH, parseInt(part.substr(7))}); // Emit effect
         }
-        else if (part.rfind("mana:", 0) == 0) {
-            int amount = stoi(part.substr(5));
-            info.actions.push(Action(MANA, amount)); // Add action to list
+        else if (part.starts_with("mana:")) {
+            info.program.push(ActionOp{ACT_MANA, parseInt(part.substr(5))}); // Emit effect
         }
-        else if (part.rfind("condition:", 0) == 0) {
-            info.condition.push(trim(part.substr(10))); // Add condition to list
+        else if (part.starts_with("timeline:")) {
+            info.program.push(ActionOp{ACT_TIMELINE, script.internTimelineName(trimView(part.substr(9)))}); // Emit effect
         }
+        else if (part.starts_with("condition:")) {
+            // Compiled once here; a bad condition disables the choice rather than passing
+            string_view expression = trimView(part.substr(10));
+            if (rejected.empty() && !info.condition.append(expression, error)) {
+                rejected = expression;
+            }
+        }
+    }
 
-        ++it;
+    // Navigation last, whatever order the parts came in; linking patches the operand
+    if (!info.targetNodeId.empty()) {
+        info.program.push(ActionOp{ACT_GOTO, UNRESOLVED});
     }
 
-    return info;
+    if (!rejected.empty()) {
+        info.condition.makeNeverTrue(rejected);
+        return false;
+    }
+    return true;
 }
 
-string DialogueGraph::trim(const string& str) {
+// Integer operand parser with stoi's contract (leading whitespace and sign
+// allowed, trailing text ignored, invalid_argument / out_of_range on failure)
+// that reads from a view instead of a string
+int DialogueGraph::parseInt(string_view str) {
+    str = trimView(str);
+    if (!str.empty() && str[0] == '+') {
+        str.remove_prefix(1);
+    }
+
+    int value = 0;
+    auto [end, error] = from_chars(str.data(), str.data() + str.size(), value);
+    if (error == errc::invalid_argument) {
+        throw invalid_argument("parseInt: no number in '" + string(str) + "'");
+    }
+    if (error == errc::result_out_of_range) {
+        throw out_of_range("parseInt: '" + string(str) + "' does not fit in int");
+    }
+    return value;
+}
+
+string_view DialogueGraph::trimView(string_view str) {
     size_t first = str.find_first_not_of(" \t\n\r");
-    if (first == string::npos) return "";
+    if (first == string_view::npos) return {};
     size_t last = str.find_last_not_of(" \t\n\r");
     return str.substr(first, (last - first + 1));
 }
 
-List<string> DialogueGraph::split(const string& str, char delimiter) {
-    List<string> result; // Returns list of string parts
-    stringstream ss(str);
-    string item;
-
-    while (getline(ss, item, delimiter)) {
-        result.push(item); // Append each part to list
-    }
-
-    return result;
+// Heap data structure utilization: schedule an action at an absolute deadline
+TimerHandle DialogueGraph::queueAction(const Action& action, float delaySeconds) {
+    TimerHandle handle = pendingActions.schedule(clock + delaySeconds, action);
+    cout << "Queued action with " << delaySeconds << "s delay (pending: " << pendingActions.size() << ")" << endl;
+    return handle;
 }
 
-// Queue data structure utilization: Add action to delayed execution queue
-void DialogueGraph::queueAction(const Action& action, float delaySeconds) {
-    pendingActions.enqueue(DelayedAction(action, delaySeconds));
-    cout << "Queued action with " << delaySeconds << "s delay (queue size: " << pendingActions.size() << ")" << endl;
+bool DialogueGraph::cancelAction(TimerHandle handle) {
+    return pendingActions.cancel(handle);
 }
 
-// Queue data structure utilization: Process delayed actions over time (FIFO)
+// Heap data structure utilization: fire every due action this tick, earliest first
 void DialogueGraph::update(float deltaTime) {
-    if (!pendingActions.isEmpty()) {
-        // Peek at front of queue without removing it yet
-        DelayedAction& frontAction = const_cast<DelayedAction&>(pendingActions.front());
-        frontAction.delaySeconds -= deltaTime;
-
-        // If delay expired, dequeue and execute
-        if (frontAction.delaySeconds <= 0) {
-            DelayedAction action = pendingActions.dequeue();
-            cout << "Executing delayed action (remaining in queue: " << pendingActions.size() << ")" << endl;
-            executeAction(action.action);
-        }
+    clock += deltaTime;
+    int fired = pendingActions.fireDue(clock, [this](const Action& action) {
+        executeAction(action);
+    });
+    if (fired > 0) {
+        cout << "Executed " << fired << " delayed action(s) (pending: " << pendingActions.size() << ")" << endl;
     }
 }
@@ -1,17 +1,21 @@
 #pragma once
 #include "HashTable.h"
 #include "List.h"
+#include "ArrayList.h"
 #include "Queue.h"
-#include "NTree.h"
+#include "TimerHeap.h"
+#include "LruCache.h"
 #include "Dialogue.h"
+#include "Condition.h"
+#include "ActionProgram.h"
+#include "DialogueImage.h"
 #include "game/Player.h"
 #include "game/Item.h"
 #include <string>
+#include <string_view>
+#include <exception>
 #include <functional>
-
-#ifndef MAX_CHOICES
-#define MAX_CHOICES 5
-#endif
+#include <memory>
 
 using namespace std;
 
@@ -27,77 +31,255 @@ struct Action {
     Action(Type t, string str, int val = 0);
 };
 
-struct DelayedAction {
-    Action action;
-    float delaySeconds;
-
-    DelayedAction() : delaySeconds(0.0f) {}
-    DelayedAction(const Action& act, float delay) : action(act), delaySeconds(delay) {}
-};
-
 struct ChoiceInfo {
     string text;
     string targetNodeId;
-    List<Action> actions;
-    List<string> condition;
+    SmallList<ActionOp, 4> program;   // Effects then GOTO (see ActionProgram.h)
+    ConditionProgram condition;       // All condition: parts, compiled and ANDed
 
     ChoiceInfo();
 };
 
+// Where a paged node's definition lives in its script (see setPageBudget)
+struct PageRef {
+    uint64_t offset = 0;       // Start of the NODE: line
+    uint32_t length = 0;       // Up to the next NODE: line or the end of the file
+    int32_t file = -1;         // Index into the graph's files; -1 when not paged
+    int32_t choiceCount = 0;
+};
+
 struct NodeInfo {
     string nodeId;
     string speaker;
     string message;
     List<ChoiceInfo> choices;
+    PageRef page;   // Paged: only nodeId is filled in, the rest is read back on demand
 
     NodeInfo();
+    [[nodiscard]] bool isPaged() const { return page.file >= 0; }
+};
+
+// Where the definition of a node ID that won precedence lives
+struct NodeLocation {
+    NodeInfo* info;
+    int fileIndex;   // Index into the graph's files, in load order
+    int line;        // Line of the NODE: header
+};
+
+// Compiled graph records. Nodes and choices live in two contiguous arrays; a
+// node's choices are the CSR range [firstChoice, firstChoice + choiceCount) of
+// the choice array, and choice targets are resolved node indices. Text and
+// effects stay in the parsed NodeInfo/ChoiceInfo (cold data) and are only
+// touched when a node is shown or a choice fires. When the graph comes from a
+// compiled image, info is null and the cold data is the image record at the same index.
+// For a paged node, info is the header and the choices' info is null.
+struct CompiledNode {
+    int firstChoice;
+    int choiceCount;
+    NodeInfo* info;
+};
+
+struct CompiledChoice {
+    int target;          // Node index, NO_TARGET, or UNRESOLVED until first linked
+    ChoiceInfo* info;
 };
 
 class DialogueGraph {
 private:
-    // HashTable data structure: Nested hash tables for file->node mapping
-    // Outer: filename -> inner hash table
-    // Inner: nodeId -> NodeInfo
-    HashTable<string, HashTable<string, NodeInfo*>*> fileNodeData;
-
-    List<string> allFiles;
-    List<NTree<Dialogue, MAX_CHOICES>*> allTreeNodes;
-    HashTable<string, NTree<Dialogue, MAX_CHOICES>*> builtNodes;
+    // HashTable data structure: Global node index over every loaded file.
+    // Precedence: the first definition of an ID wins (earlier files, then
+    // earlier lines); later ones are reported and ignored, so loading another
+    // file never changes a node that is already compiled.
+    // Keys view NodeInfo::nodeId, which lives as long as the entry.
+    HashTable<string_view, NodeLocation> nodeIndex;
+
+    ArrayList<string> allFiles;
     List<NodeInfo*> allNodeInfos;
 
+    // ArrayList data structure: Compiled graph (see CompiledNode)
+    ArrayList<CompiledNode> nodes;
+    ArrayList<CompiledChoice> edges;
+    HashTable<string, int> builtNodes;   // nodeId -> index into nodes
+    DialogueImage image;                 // Open when the graph was loaded from a compiled image
+
+    // Item specs ("name:type:bonus") referenced by ACT_ITEM operands, interned,
+    // and the ItemRegistry prototype of each, so an ACT_ITEM is one array read.
+    // Mutable: reading a paged node back can add specs, from const accessors too.
+    mutable ArrayList<string> itemSpecs;
+    mutable HashTable<string, int> itemSpecIndex;
+    mutable ArrayList<const ItemPrototype*> itemPrototypes;
+
+    // Timeline names referenced by ACT_TIMELINE operands, interned the same way
+    mutable ArrayList<string> timelineNames;
+    mutable HashTable<string, int> timelineNameIndex;
+
+    // LruCache data structure: Payloads of paged nodes by node index, bounded
+    // by approximate heap bytes. Filled on first use, so mutable.
+    mutable LruCache<int, unique_ptr<NodeInfo>> pageCache;
+    bool pagedLoading;   // Set by a nonzero page budget; applies to scripts loaded afterwards
+
+    // Double-buffered Dialogue views handed to the UI. A choice's action runs
+    // from inside the shown view, so the next node is always written to the other one.
+    Dialogue views[2];
+    int activeView;
+
     string rootNodeId;
     Player* playerRef;
-    function<void(NTree<Dialogue, MAX_CHOICES>*, const string&)> onDialogueStart;
-    NTree<Dialogue, MAX_CHOICES>* rootTree;
+    function<void(Dialogue*, string_view)> onDialogueStart;
+    function<void(string_view)> onTimelineStart;
+    int rootNode;
+
+    // Build options: lazy builds resolve each choice target on first use;
+    // eager builds link everything reachable, reporting through buildProgress
+    bool lazyBuild;
+    function<bool(int, int)> buildProgress;
+
+    int reloadCount;
 
-    // Queue data structure: Pending delayed actions (FIFO)
-    Queue<DelayedAction> pendingActions;
+    // Heap data structure: Pending delayed actions ordered by absolute deadline
+    TimerHeap<Action> pendingActions;
+    double clock;   // Seconds of update() time so far; deadlines are on this clock
 
 public:
     explicit DialogueGraph(Player& player);
     ~DialogueGraph();
 
-    void setDialogueStartCallback(function<void(NTree<Dialogue, MAX_CHOICES>*, const string&)> callback);
+    static constexpr int NO_TARGET = -1;
+    static constexpr int UNRESOLVED = -2;
+    static constexpr int PROGRESS_INTERVAL = 1024;   // Nodes linked between progress reports
+
+    void setDialogueStartCallback(function<void(Dialogue*, string_view)> callback);
+
+    // Called with the name from a choice's "timeline:<name>" effect
+    void setTimelineCallback(function<void(string_view)> callback) { onTimelineStart = std::move(callback); }
     bool loadFromFile(const string& filename);
     bool loadAdditionalFile(const string& filename);
 
-    // NTree data structure: Build and access dialogue tree
-    NTree<Dialogue, MAX_CHOICES>* buildTree();
-    NTree<Dialogue, MAX_CHOICES>* getNode(const string& nodeId);
+    // Batch loading: files are parsed concurrently, then merged in list order
+    // with the same precedence and diagnostics as loadFromFile followed by
+    // loadAdditionalFile for the rest. Replaces whatever was loaded.
+    bool loadFiles(const List<string>& filenames);
+    bool loadDirectory(const string& directory);       // Its *.txt files, sorted by name
+    bool loadManifest(const string& manifestFile);     // Paths relative to the manifest, one per line
+
+    // Hot reload: re-parse one loaded script and patch the graph in place.
+    // Unchanged nodes are kept; changed and added nodes take effect at once,
+    // under the same node index, so views and saved positions stay valid.
+    // IDs the file no longer defines leave the index but stay compiled (their
+    // ID can still be shown). An unknown file is loaded as an additional file.
+    // A script that fails to parse leaves the graph untouched.
+    bool reloadFile(const string& filename);
+    // Bumped by every reload that changed something; views built before it may be stale
+    [[nodiscard]] int getReloadCount() const { return reloadCount; }
+
+    // Use a compiled image if it matches scriptFiles (or they are absent),
+    // otherwise parse scriptFiles as text, in order
+    bool loadCompiled(const string& imageFile, const List<string>& scriptFiles);
+    // Compile every loaded node and write a binary image (text-loaded graphs only)
+    bool saveImage(const string& imageFile, uint64_t sourceHash);
 
-    // Queue data structure methods: Delayed action system (FIFO)
-    void queueAction(const Action& action, float delaySeconds);
+    // Compile the root (and, unless lazy, everything reachable from it) and
+    // return the root's view. Returned views stay valid until the next-but-one navigation.
+    Dialogue* buildTree();
+    void setLazyBuild(bool lazy) { lazyBuild = lazy; }
+    // Called as (nodesBuilt, nodesQueued) every PROGRESS_INTERVAL linked nodes and
+    // once at the end; returning false stops the eager build, leaving the rest lazy
+    void setBuildProgressCallback(function<bool(int, int)> callback) { buildProgress = std::move(callback); }
+    Dialogue* getNode(string_view nodeId);
+
+    // Compiled graph access (index-based navigation)
+    int findNode(string_view nodeId);
+    Dialogue* showNode(int nodeIndex);
+    [[nodiscard]] int getNodeCount() const { return nodes.length(); }
+    [[nodiscard]] int getTarget(int nodeIndex, int choice) const { return edges[nodes[nodeIndex].firstChoice + choice].target; }
+    string_view getNodeId(int nodeIndex) const;
+
+    // Whole-graph access for tools (analysis, image compilation)
+    int compileAll();
+    [[nodiscard]] int getRootNode() const { return rootNode; }
+    [[nodiscard]] int getChoiceCount(int nodeIndex) const { return nodes[nodeIndex].choiceCount; }
+    string_view getChoiceText(int nodeIndex, int choice) const;
+    string_view getTargetId(int nodeIndex, int choice) const;   // As written; empty if the choice has none
+    const ConditionProgram* getCondition(int nodeIndex, int choice) const;   // Null for image-backed graphs
+    const NodeLocation* getNodeLocation(string_view nodeId) const { return nodeIndex.search(nodeId); }
+    const string& getFileName(int fileIndex) const { return allFiles[fileIndex]; }
+
+    // Paged mode for very large script sets: scripts loaded after this keep
+    // only node headers (IDs and where each node is in its file) resident, and
+    // a node's text and choices are parsed again from the script when needed,
+    // into a cache of about budgetBytes. 0, the default, keeps whole nodes
+    // resident. Paged graphs cannot be hot-reloaded or saved as images, and
+    // views into paged data (getChoiceText, getCondition) last until the next
+    // node is read back.
+    void setPageBudget(size_t budgetBytes);
+    LruStats getPageStats() const { return pageCache.getStats(); }
+
+    // Probe statistics of the built-node cache, for checking hash quality on real node IDs
+    HashTableStats getLookupStats() const { return builtNodes.getStats(); }
+
+    // Delayed action system: every action whose deadline has passed fires on the
+    // next update, in deadline order (ties in queueing order)
+    TimerHandle queueAction(const Action& action, float delaySeconds);
+    bool cancelAction(TimerHandle handle);
+    [[nodiscard]] int getPendingActionCount() const { return pendingActions.size(); }
     void update(float deltaTime);
 
 private:
+    // One script parsed off the graph (on any thread), waiting to be merged
+    struct ParsedNode {
+        NodeInfo* info;
+        int line;
+    };
+    struct ParsedScript {
+        ArrayList<ParsedNode> nodes;           // Owned until merged
+        string rootNodeId;
+        bool hasRoot = false;
+        ArrayList<string> itemSpecs;           // ACT_ITEM operands index these until merged
+        HashTable<string, int> itemSpecIndex;
+        ArrayList<ItemPrototype> itemDefinitions;  // Parsed from itemSpecs, interned on merge
+        ArrayList<string> timelineNames;       // ACT_TIMELINE operands index these until merged
+        HashTable<string, int> timelineNameIndex;
+        string diagnostics;
+        exception_ptr failure;                 // Parser exception, rethrown on merge
+        bool opened = false;
+        bool paged = false;                    // Nodes are headers (see PageRef)
+
+        ParsedScript() = default;
+        ParsedScript(ParsedScript&&) = default;
+        ~ParsedScript();
+        int internItemSpec(string_view itemSpec);
+        int internTimelineName(string_view name);
+    };
+
     bool loadFile(const string& filename, bool isFirstFile);
-    NTree<Dialogue, MAX_CHOICES>* buildNode(const string& nodeId);
-    function<void()> createAction(const ChoiceInfo& choiceInfo, NTree<Dialogue, MAX_CHOICES>* targetNode);
+    static void parseScript(const string& filename, ParsedScript& out, bool paged);
+    static void parseNodeLine(string_view line, NodeInfo& node, ParsedScript& script, const string& filename, int lineNumber);
+    ArrayList<int> adoptItemSpecs(const ParsedScript& parsed) const;
+    ArrayList<int> adoptTimelineNames(const ParsedScript& parsed) const;
+    static void remapOperands(NodeInfo& node, const ArrayList<int>& itemRemap, const ArrayList<int>& timelineRemap);
+    NodeInfo* pageIn(int nodeIndex) const;
+    ChoiceInfo* choiceAt(int nodeIndex, int edgeIndex) const;
+    static size_t payloadBytes(const NodeInfo& info);
+    bool mergeScript(const string& filename, ParsedScript& parsed, bool isFirstFile);
+    static void reportReloadFailure(const string& filename, const exception_ptr& failure);
+    void indexNode(NodeInfo* node, int fileIndex, int line);
+    void relinkMissingTargets();
+    void replaceNode(const NodeLocation& current, NodeInfo* replacement, int fileIndex, int line);
+    static bool sameContent(const NodeInfo& a, const NodeInfo& b);
+    void clearSources();
+    void clearCompiled();
+    bool useImage();
+    int buildNode(string_view nodeId);
+    int compileNode(string_view nodeId);
+    int resolveTarget(int nodeIndex, int edgeIndex);
+    void linkReachable(int startIndex);
+    void fireChoice(int nodeIndex, int edgeIndex);
+    void runProgram(const ActionOp* program, int length, int nodeIndex, int edgeIndex);
     void executeAction(const Action& action);
-    bool evaluateCondition(const string& condition);
-    static Item createItemFromString(const string& itemStr);
-    static ItemType stringToItemType(const string& typeStr);
-    static ChoiceInfo parseChoice(const string& choiceLine);
-    static string trim(const string& str);
-    static List<string> split(const string& str, char delimiter);
+    void applyEffect(Type type, int amount, const ItemPrototype* item);
+    int internItemSpec(string_view itemSpec, const ItemPrototype& definition) const;
+    int internTimelineName(string_view name) const;
+    static bool parseChoice(string_view choiceLine, ChoiceInfo& info, ParsedScript& script, string& error);
+    static int parseInt(string_view str);
+    static string_view trimView(string_view str);
 };
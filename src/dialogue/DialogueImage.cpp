@@ -0,0 +1,192 @@
+#include "DialogueImage.h"
+#include "Hasher.h"
+#include <cstring>
+
+using namespace DialogueImageFormat;
+
+DialogueImage::DialogueImage()
+    : header(nullptr), nodes(nullptr), choices(nullptr), actionOps(nullptr), itemSpecs(nullptr),
+      conditionOps(nullptr), conditionNames(nullptr), timelineNames(nullptr), sortedNodes(nullptr), strings(nullptr) {}
+
+bool DialogueImage::open(const string& filename) {
+    close();
+    if (!file.open(filename, ScriptFile::Access::RANDOM) || file.size() < sizeof(ImageHeader)) {
+        close();
+        return false;
+    }
+
+    const char* base = file.contents().data();
+    const ImageHeader* candidate = reinterpret_cast<const ImageHeader*>(base);
+    if (memcmp(candidate->magic, MAGIC, sizeof(MAGIC)) != 0 ||
+        candidate->version != VERSION || candidate->endianTag != ENDIAN_TAG) {
+        close();
+        return false;
+    }
+
+    // Section sizes in 64-bit so a corrupt count cannot wrap
+    uint64_t expected = sizeof(ImageHeader)
+        + uint64_t(candidate->nodeCount) * sizeof(ImageNode)
+        + uint64_t(candidate->choiceCount) * sizeof(ImageChoice)
+        + uint64_t(candidate->actionOpCount) * sizeof(ActionOp)
+        + uint64_t(candidate->itemSpecCount) * sizeof(ImageStringRef)
+        + uint64_t(candidate->conditionOpCount) * sizeof(ConditionOp)
+        + uint64_t(candidate->conditionNameCount) * sizeof(ImageStringRef)
+        + uint64_t(candidate->timelineNameCount) * sizeof(ImageStringRef)
+        + uint64_t(candidate->nodeCount) * sizeof(uint32_t)
+        + candidate->stringPoolSize;
+    if (expected != file.size()) {
+        close();
+        return false;
+    }
+
+    const char* cursor = base + sizeof(ImageHeader);
+    nodes = reinterpret_cast<const ImageNode*>(cursor);
+    cursor += candidate->nodeCount * sizeof(ImageNode);
+    choices = reinterpret_cast<const ImageChoice*>(cursor);
+    cursor += candidate->choiceCount * sizeof(ImageChoice);
+    actionOps = reinterpret_cast<const ActionOp*>(cursor);
+    cursor += candidate->actionOpCount * sizeof(ActionOp);
+    itemSpecs = reinterpret_cast<const ImageStringRef*>(cursor);
+    cursor += candidate->itemSpecCount * sizeof(ImageStringRef);
+    conditionOps = reinterpret_cast<const ConditionOp*>(cursor);
+    cursor += candidate->conditionOpCount * sizeof(ConditionOp);
+    conditionNames = reinterpret_cast<const ImageStringRef*>(cursor);
+    cursor += candidate->conditionNameCount * sizeof(ImageStringRef);
+    timelineNames = reinterpret_cast<const ImageStringRef*>(cursor);
+    cursor += candidate->timelineNameCount * sizeof(ImageStringRef);
+    sortedNodes = reinterpret_cast<const uint32_t*>(cursor);
+    cursor += candidate->nodeCount * sizeof(uint32_t);
+    strings = cursor;
+    header = candidate;
+
+    if (!validate()) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+// One pass over the records so lookups never need bounds checks
+bool DialogueImage::validate() const {
+    auto validString = [this](ImageStringRef ref) {
+        return uint64_t(ref.offset) + ref.length <= header->stringPoolSize;
+    };
+    auto validRange = [](uint32_t first, uint32_t count, uint32_t total) {
+        return uint64_t(first) + count <= total;
+    };
+    auto validNode = [this](int32_t index) {
+        return index == NO_NODE || (index >= 0 && uint32_t(index) < header->nodeCount);
+    };
+
+    if (!validNode(header->rootNode)) {
+        return false;
+    }
+    for (uint32_t i = 0; i < header->nodeCount; ++i) {
+        const ImageNode& node = nodes[i];
+        if (!validString(node.id) || !validString(node.speaker) || !validString(node.message) ||
+            !validRange(node.firstChoice, node.choiceCount, header->choiceCount) ||
+            sortedNodes[i] >= header->nodeCount) {
+            return false;
+        }
+    }
+    for (uint32_t i = 0; i < header->choiceCount; ++i) {
+        const ImageChoice& choice = choices[i];
+        if (!validString(choice.text) || !validString(choice.conditionSource) || !validNode(choice.target) ||
+            !validRange(choice.firstActionOp, choice.actionOpCount, header->actionOpCount) ||
+            !validRange(choice.firstConditionOp, choice.conditionOpCount, header->conditionOpCount) ||
+            !ConditionProgram::verify(conditionOps + choice.firstConditionOp, static_cast<int>(choice.conditionOpCount),
+                                      static_cast<int>(header->conditionNameCount))) {
+            return false;
+        }
+    }
+    for (uint32_t i = 0; i < header->choiceCount; ++i) {
+        // Effects, then at most one GOTO, which must be the choice's own target
+        const ImageChoice& choice = choices[i];
+        for (uint32_t j = 0; j < choice.actionOpCount; ++j) {
+            const ActionOp& op = actionOps[choice.firstActionOp + j];
+            bool valid;
+            switch (op.opcode) {
+                case ACT_GOLD: case ACT_XP: case ACT_HEALTH: case ACT_MANA:
+                    valid = true;
+                    break;
+                case ACT_ITEM:
+                    valid = op.operand >= 0 && uint32_t(op.operand) < header->itemSpecCount;
+                    break;
+                case ACT_TIMELINE:
+                    valid = op.operand >= 0 && uint32_t(op.operand) < header->timelineNameCount;
+                    break;
+                case ACT_GOTO:
+                    valid = j + 1 == choice.actionOpCount && op.operand == choice.target;
+                    break;
+                default:
+                    valid = false;
+            }
+            if (!valid) {
+                return false;
+            }
+        }
+    }
+    for (uint32_t i = 0; i < header->itemSpecCount; ++i) {
+        if (!validString(itemSpecs[i])) {
+            return false;
+        }
+    }
+    for (uint32_t i = 0; i < header->conditionNameCount; ++i) {
+        if (!validString(conditionNames[i])) {
+            return false;
+        }
+    }
+    for (uint32_t i = 0; i < header->timelineNameCount; ++i) {
+        if (!validString(timelineNames[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void DialogueImage::close() {
+    file.close();
+    header = nullptr;
+    nodes = nullptr;
+    choices = nullptr;
+    actionOps = nullptr;
+    itemSpecs = nullptr;
+    conditionOps = nullptr;
+    conditionNames = nullptr;
+    timelineNames = nullptr;
+    sortedNodes = nullptr;
+    strings = nullptr;
+}
+
+int DialogueImage::findNode(string_view nodeId) const {
+    // Binary search data structure utilization: sortedNodes orders node indices by ID
+    uint32_t low = 0;
+    uint32_t high = header->nodeCount;
+    while (low < high) {
+        uint32_t middle = low + (high - low) / 2;
+        int order = getString(nodes[sortedNodes[middle]].id).compare(nodeId);
+        if (order == 0) {
+            return static_cast<int>(sortedNodes[middle]);
+        }
+        if (order < 0) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    return NO_NODE;
+}
+
+bool DialogueImage::hashSources(const List<string>& filenames, uint64_t& hash) {
+    // Fixed seed (not the per-process hashSeed) so the value is stable across runs
+    hash = 0x243f6a8885a308d3ull;
+    for (const string& filename : filenames) {
+        ScriptFile source;
+        if (!source.open(filename)) {
+            return false;
+        }
+        string_view text = source.contents();
+        hash = wyhash::hash(text.data(), text.size(), hash);
+    }
+    return true;
+}
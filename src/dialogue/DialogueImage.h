@@ -0,0 +1,118 @@
+#pragma once
+#include "ScriptFile.h"
+#include "Condition.h"
+#include "ActionProgram.h"
+#include "List.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+using namespace std;
+
+// Binary dialogue image: a script set compiled ahead of time, read in place.
+// Layout (native little-endian, every section 4-byte aligned):
+//   ImageHeader
+//   ImageNode[nodeCount]            node table, choices as [firstChoice, +choiceCount)
+//   ImageChoice[choiceCount]        targets are resolved node indices
+//   ActionOp[actionOpCount]         choice programs (see ActionProgram.h)
+//   ImageStringRef[itemSpecCount]   item specs used by ACT_ITEM
+//   ConditionOp[conditionOpCount]   compiled condition bytecode (see Condition.h)
+//   ImageStringRef[conditionNameCount]  item names used by COND_HAS_ITEM
+//   ImageStringRef[timelineNameCount]   timeline names used by ACT_TIMELINE
+//   uint32_t[nodeCount]             node indices sorted by ID, for lookup
+//   char[stringPoolSize]            string pool (not NUL-terminated)
+// sourceHash identifies the script text the image was compiled from, so a
+// stale image can be detected and the text parser used instead.
+namespace DialogueImageFormat {
+    constexpr char MAGIC[4] = {'D', 'L', 'G', 'C'};
+    constexpr uint32_t VERSION = 4;
+    constexpr uint32_t ENDIAN_TAG = 0x01020304;
+    constexpr int32_t NO_NODE = -1;
+}
+
+struct ImageHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t endianTag;
+    int32_t rootNode;
+    uint64_t sourceHash;
+    uint32_t nodeCount;
+    uint32_t choiceCount;
+    uint32_t actionOpCount;
+    uint32_t conditionOpCount;
+    uint32_t stringPoolSize;
+    uint32_t conditionNameCount;
+    uint32_t itemSpecCount;
+    uint32_t timelineNameCount;
+};
+
+struct ImageStringRef {
+    uint32_t offset;
+    uint32_t length;
+};
+
+struct ImageNode {
+    ImageStringRef id;
+    ImageStringRef speaker;
+    ImageStringRef message;
+    uint32_t firstChoice;
+    uint32_t choiceCount;
+};
+
+struct ImageChoice {
+    ImageStringRef text;
+    int32_t target;
+    uint32_t firstActionOp;
+    uint32_t actionOpCount;
+    ImageStringRef conditionSource;
+    uint32_t firstConditionOp;
+    uint32_t conditionOpCount;
+};
+
+// Read-only, memory-mapped view of a compiled image
+class DialogueImage {
+private:
+    ScriptFile file;
+    const ImageHeader* header;
+    const ImageNode* nodes;
+    const ImageChoice* choices;
+    const ActionOp* actionOps;
+    const ImageStringRef* itemSpecs;
+    const ConditionOp* conditionOps;
+    const ImageStringRef* conditionNames;
+    const ImageStringRef* timelineNames;
+    const uint32_t* sortedNodes;
+    const char* strings;
+
+    bool validate() const;
+
+public:
+    DialogueImage();
+
+    // Map and validate an image; false (and closed) if missing or malformed
+    bool open(const string& filename);
+    void close();
+    [[nodiscard]] bool isOpen() const { return header != nullptr; }
+
+    [[nodiscard]] uint64_t getSourceHash() const { return header->sourceHash; }
+    [[nodiscard]] int getRootNode() const { return header->rootNode; }
+    [[nodiscard]] int getNodeCount() const { return static_cast<int>(header->nodeCount); }
+    [[nodiscard]] int getChoiceCount() const { return static_cast<int>(header->choiceCount); }
+    [[nodiscard]] int getItemSpecCount() const { return static_cast<int>(header->itemSpecCount); }
+
+    const ImageNode& getNode(int index) const { return nodes[index]; }
+    const ImageChoice& getChoice(int index) const { return choices[index]; }
+    const ActionOp* getActionOps(const ImageChoice& choice) const { return actionOps + choice.firstActionOp; }
+    string_view getItemSpec(int index) const { return getString(itemSpecs[index]); }
+    const ConditionOp* getConditionOps(const ImageChoice& choice) const { return conditionOps + choice.firstConditionOp; }
+    string_view getConditionName(int index) const { return getString(conditionNames[index]); }
+    string_view getTimelineName(int index) const { return getString(timelineNames[index]); }
+    string_view getString(ImageStringRef ref) const { return string_view(strings + ref.offset, ref.length); }
+
+    // Node index for an ID (binary search over the sorted index), or NO_NODE
+    [[nodiscard]] int findNode(string_view nodeId) const;
+
+    // Hash of the scripts' contents, in load order; false if one cannot be read
+    static bool hashSources(const List<string>& filenames, uint64_t& hash);
+};
@@ -0,0 +1,70 @@
+#include "ScriptFile.h"
+#include <fstream>
+#include <iterator>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define SCRIPT_FILE_MMAP 1
+#endif
+
+ScriptFile::ScriptFile() : data(nullptr), length(0), mapped(false) {}
+
+ScriptFile::~ScriptFile() {
+    close();
+}
+
+bool ScriptFile::open(const string& filename, Access access) {
+    close();
+
+#ifdef SCRIPT_FILE_MMAP
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+
+    struct stat info {};
+    if (fstat(fd, &info) != 0) {
+        ::close(fd);
+        return false;
+    }
+
+    length = static_cast<size_t>(info.st_size);
+    if (length > 0) {
+        void* address = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (address == MAP_FAILED) {
+            ::close(fd);
+            length = 0;
+            return false;
+        }
+        madvise(address, length, access == Access::RANDOM ? MADV_RANDOM : MADV_SEQUENTIAL);
+        data = static_cast<const char*>(address);
+        mapped = true;
+    }
+    ::close(fd); // The mapping keeps the file contents reachable
+    return true;
+#else
+    ifstream file(filename, ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+    buffer.assign(istreambuf_iterator<char>(file), istreambuf_iterator<char>());
+    data = buffer.data();
+    length = buffer.size();
+    return true;
+#endif
+}
+
+void ScriptFile::close() {
+#ifdef SCRIPT_FILE_MMAP
+    if (mapped) {
+        munmap(const_cast<char*>(data), length);
+    }
+#endif
+    buffer.clear();
+    data = nullptr;
+    length = 0;
+    mapped = false;
+}
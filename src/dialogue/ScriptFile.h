@@ -0,0 +1,37 @@
+#pragma once
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+using namespace std;
+
+// Read-only view of a whole file (scripts and compiled images). On POSIX systems it is
+// memory-mapped, so readers work straight from the page cache with no copy;
+// elsewhere it falls back to reading the file into one buffer.
+class ScriptFile {
+private:
+    const char* data;
+    size_t length;
+    bool mapped;       // data came from mmap (otherwise it is buffer's storage)
+    string buffer;     // Fallback storage when mapping is unavailable
+
+public:
+    // How the contents will be read, passed on to the OS as a paging hint
+    enum class Access {
+        SEQUENTIAL,   // One front-to-back pass (parsing a script)
+        RANDOM        // Jumps through an index (compiled images)
+    };
+
+    ScriptFile();
+    ~ScriptFile();
+
+    // A mapping has a single owner
+    ScriptFile(const ScriptFile&) = delete;
+    ScriptFile& operator=(const ScriptFile&) = delete;
+
+    bool open(const string& filename, Access access = Access::SEQUENTIAL);
+    void close();
+
+    [[nodiscard]] string_view contents() const { return string_view(data, length); }
+    [[nodiscard]] size_t size() const { return length; }
+};
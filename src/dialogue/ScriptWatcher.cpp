@@ -0,0 +1,95 @@
+#include "ScriptWatcher.h"
+#include <iostream>
+
+#ifdef __linux__
+#include <cerrno>
+#include <cstring>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+ScriptWatcher::ScriptWatcher() : notifyFd(-1) {}
+
+ScriptWatcher::~ScriptWatcher() {
+#ifdef __linux__
+    if (notifyFd >= 0) {
+        ::close(notifyFd);
+    }
+#endif
+}
+
+bool ScriptWatcher::isSupported() {
+#ifdef __linux__
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool ScriptWatcher::watchDirectory(const string& directory) {
+#ifdef __linux__
+    if (notifyFd < 0) {
+        notifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        if (notifyFd < 0) {
+            cerr << "inotify unavailable: " << strerror(errno) << endl;
+            return false;
+        }
+    }
+
+    // IN_CLOSE_WRITE: saved in place; IN_MOVED_TO: saved through a rename
+    int watch = inotify_add_watch(notifyFd, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO);
+    if (watch < 0) {
+        cerr << "Cannot watch " << directory << ": " << strerror(errno) << endl;
+        return false;
+    }
+    directories.insert(watch, directory);
+    return true;
+#else
+    cerr << "Script watching is not supported on this platform" << endl;
+    (void)directory;
+    return false;
+#endif
+}
+
+void ScriptWatcher::poll(ArrayList<string>& changedFiles) {
+#ifdef __linux__
+    if (notifyFd < 0) {
+        return;
+    }
+
+    int firstNew = changedFiles.length();
+    alignas(inotify_event) char buffer[4096];
+    while (true) {
+        ssize_t bytes = ::read(notifyFd, buffer, sizeof(buffer));
+        if (bytes <= 0) {
+            break; // EAGAIN: nothing more queued
+        }
+
+        for (char* cursor = buffer; cursor < buffer + bytes;) {
+            auto* event = reinterpret_cast<inotify_event*>(cursor);
+            cursor += sizeof(inotify_event) + event->len;
+
+            const string* directory = directories.search(event->wd);
+            if (!directory || event->len == 0 || (event->mask & IN_ISDIR)) {
+                continue;
+            }
+            string_view name(event->name);
+            if (!name.ends_with(".txt")) {
+                continue;
+            }
+
+            // An editor save can raise several events; report each file once
+            string path = *directory + "/" + string(name);
+            bool seen = false;
+            for (int i = firstNew; i < changedFiles.length() && !seen; ++i) {
+                seen = changedFiles[i] == path;
+            }
+            if (!seen) {
+                changedFiles.push(std::move(path));
+            }
+        }
+    }
+#else
+    (void)changedFiles;
+#endif
+}
@@ -0,0 +1,32 @@
+#pragma once
+#include "ArrayList.h"
+#include "HashTable.h"
+#include <string>
+
+using namespace std;
+
+// Reports dialogue scripts that were saved in watched directories.
+// Directories are watched rather than files because editors often save by
+// writing a new file and renaming it over the old one. Uses inotify on Linux;
+// elsewhere watchDirectory fails and poll reports nothing.
+class ScriptWatcher {
+private:
+    int notifyFd;
+    HashTable<int, string> directories;   // Watch descriptor -> directory path
+
+public:
+    ScriptWatcher();
+    ~ScriptWatcher();
+
+    ScriptWatcher(const ScriptWatcher&) = delete;
+    ScriptWatcher& operator=(const ScriptWatcher&) = delete;
+
+    static bool isSupported();
+
+    bool watchDirectory(const string& directory);
+    [[nodiscard]] bool isActive() const { return !directories.isEmpty(); }
+
+    // Append each .txt file written or moved into a watched directory since
+    // the last poll (once per file); never blocks
+    void poll(ArrayList<string>& changedFiles);
+};
@@ -0,0 +1,169 @@
+#include "Timeline.h"
+#include <exception>
+#include <iostream>
+#include <new>
+
+FrameArena::FrameArena() {
+    for (FreeBlock*& list : freeLists) {
+        list = nullptr;
+    }
+}
+
+FrameArena::~FrameArena() {
+    for (void* chunk : chunks) {
+        ::operator delete(chunk);
+    }
+}
+
+void* FrameArena::allocate(size_t size) {
+    size_t sizeClass = (size + GRANULE - 1) / GRANULE - 1;
+    if (sizeClass >= CLASS_COUNT) {
+        return ::operator new(size);
+    }
+
+    if (!freeLists[sizeClass]) {
+        // Carve a new chunk into blocks of this class
+        size_t blockSize = (sizeClass + 1) * GRANULE;
+        auto* chunk = static_cast<unsigned char*>(::operator new(blockSize * BLOCKS_PER_CHUNK));
+        chunks.push(chunk);
+        for (int i = BLOCKS_PER_CHUNK - 1; i >= 0; --i) {
+            auto* block = reinterpret_cast<FreeBlock*>(chunk + blockSize * static_cast<size_t>(i));
+            block->next = freeLists[sizeClass];
+            freeLists[sizeClass] = block;
+        }
+    }
+
+    FreeBlock* block = freeLists[sizeClass];
+    freeLists[sizeClass] = block->next;
+    return block;
+}
+
+void FrameArena::release(void* block, size_t size) {
+    size_t sizeClass = (size + GRANULE - 1) / GRANULE - 1;
+    if (sizeClass >= CLASS_COUNT) {
+        ::operator delete(block);
+        return;
+    }
+    auto* freed = static_cast<FreeBlock*>(block);
+    freed->next = freeLists[sizeClass];
+    freeLists[sizeClass] = freed;
+}
+
+void Timeline::promise_type::unhandled_exception() {
+    try {
+        throw;
+    } catch (const exception& e) {
+        cerr << "Timeline stopped by exception: " << e.what() << endl;
+    } catch (...) {
+        cerr << "Timeline stopped by unknown exception" << endl;
+    }
+}
+
+TimelineRegistry& TimelineRegistry::global() {
+    static TimelineRegistry registry;
+    return registry;
+}
+
+bool TimelineRegistry::start(string_view name, TimelineScheduler& scheduler, Player& player) const {
+    const Factory* factory = factories.search(name);
+    if (!factory) {
+        return false;
+    }
+    scheduler.start((*factory)(scheduler, player));
+    return true;
+}
+
+TimelineScheduler::TimelineScheduler() : clock(0.0), wakeDepth(0) {}
+
+TimelineScheduler::~TimelineScheduler() {
+    stopAll();
+}
+
+void TimelineScheduler::start(Timeline timeline) {
+    Timeline::Handle handle = timeline.release();
+    if (!handle) {
+        return;
+    }
+    running.push(handle);
+    handle.resume();
+}
+
+void TimelineScheduler::stopAll() {
+    // Forget every suspension point first: the handles are about to dangle
+    timers.clear();
+    inputWaiters.clear();
+    nodeWaiters.clear();
+    for (Timeline::Handle handle : running) {
+        handle.destroy();
+    }
+    running.clear();
+}
+
+void TimelineScheduler::update(float deltaTime) {
+    clock += deltaTime;
+    timers.fireDue(clock, [](coroutine_handle<> handle) {
+        handle.resume();
+    });
+    reapFinished();
+}
+
+void TimelineScheduler::notifyInput() {
+    // Resume from a copy: a resumed timeline may wait for input again
+    ArrayList<coroutine_handle<>>& woken = beginWake();
+    for (coroutine_handle<> handle : inputWaiters) {
+        woken.push(handle);
+    }
+    inputWaiters.clear();
+    finishWake();
+}
+
+void TimelineScheduler::notifyNodeEntered(string_view nodeId) {
+    // Matching waiters leave the list before any of them runs
+    ArrayList<coroutine_handle<>>& woken = beginWake();
+    int kept = 0;
+    for (int i = 0; i < nodeWaiters.length(); ++i) {
+        if (nodeWaiters[i].nodeId == nodeId) {
+            woken.push(nodeWaiters[i].handle);
+        } else {
+            nodeWaiters[kept++] = nodeWaiters[i];
+        }
+    }
+    while (nodeWaiters.length() > kept) {
+        nodeWaiters.pop();
+    }
+    finishWake();
+}
+
+ArrayList<coroutine_handle<>>& TimelineScheduler::beginWake() {
+    if (wakeDepth == wakeLists.length()) {
+        wakeLists.emplace();
+    }
+    return wakeLists[wakeDepth];
+}
+
+// Resume this level's handles. A nested event may add a level and move the
+// buffers, so each handle is read by index rather than through a reference.
+void TimelineScheduler::finishWake() {
+    int level = wakeDepth++;
+    for (int i = 0; i < wakeLists[level].length(); ++i) {
+        wakeLists[level][i].resume();
+    }
+    wakeLists[level].clear();
+    --wakeDepth;
+    reapFinished();
+}
+
+// Destroy frames that reached final_suspend, compacting the running list
+void TimelineScheduler::reapFinished() {
+    int kept = 0;
+    for (int i = 0; i < running.length(); ++i) {
+        if (running[i].done()) {
+            running[i].destroy();
+        } else {
+            running[kept++] = running[i];
+        }
+    }
+    while (running.length() > kept) {
+        running.pop();
+    }
+}
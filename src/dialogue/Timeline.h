@@ -0,0 +1,215 @@
+#pragma once
+#include "ArrayList.h"
+#include "HashTable.h"
+#include "TimerHeap.h"
+#include <coroutine>
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <utility>
+
+using namespace std;
+
+class TimelineScheduler;
+class Player;
+
+// Fixed-size-class pool for coroutine frames. Sizes round up to 64-byte classes
+// (up to 1 KB); each class keeps a free list refilled a chunk of blocks at a
+// time, so starting a timeline after warm-up does not touch the heap.
+// Larger frames fall back to operator new.
+class FrameArena {
+private:
+    static constexpr size_t GRANULE = 64;
+    static constexpr int CLASS_COUNT = 16;
+    static constexpr int BLOCKS_PER_CHUNK = 32;
+
+    struct FreeBlock {
+        FreeBlock* next;
+    };
+
+    FreeBlock* freeLists[CLASS_COUNT];
+    ArrayList<void*> chunks;
+
+public:
+    FrameArena();
+    ~FrameArena();
+
+    FrameArena(const FrameArena&) = delete;
+    FrameArena& operator=(const FrameArena&) = delete;
+
+    void* allocate(size_t size);
+    void release(void* block, size_t size);
+};
+
+// A scripted sequence written as a coroutine, e.g.
+//
+//   Timeline rewardAfterPause(TimelineScheduler& timelines, Player& player) {
+//       co_await timelines.delay(2.0f);
+//       player.getInventory().addGold(50);
+//       co_await timelines.waitForInput();
+//   }
+//
+// The scheduler must be the first parameter: the frame is allocated from its
+// arena. Nothing runs until the Timeline is passed to TimelineScheduler::start.
+class Timeline {
+public:
+    struct promise_type {
+        Timeline get_return_object() { return Timeline(Handle::from_promise(*this)); }
+        suspend_always initial_suspend() noexcept { return {}; }
+        suspend_always final_suspend() noexcept { return {}; }   // The scheduler reaps finished frames
+        void return_void() {}
+        void unhandled_exception();
+
+        template <class... Args>
+        static void* operator new(size_t size, TimelineScheduler& scheduler, Args&...);
+        static void operator delete(void* frame, size_t size);
+    };
+    using Handle = coroutine_handle<promise_type>;
+
+    Timeline(Timeline&& other) noexcept : handle(std::exchange(other.handle, {})) {}
+    Timeline& operator=(Timeline&& other) noexcept {
+        if (this != &other) {
+            if (handle) handle.destroy();
+            handle = std::exchange(other.handle, {});
+        }
+        return *this;
+    }
+    Timeline(const Timeline&) = delete;
+    Timeline& operator=(const Timeline&) = delete;
+    ~Timeline() {
+        if (handle) handle.destroy();
+    }
+
+private:
+    friend class TimelineScheduler;
+    explicit Timeline(Handle h) : handle(h) {}
+    Handle release() { return std::exchange(handle, {}); }
+
+    Handle handle;
+};
+
+// Runs timelines from the game loop. update() advances the clock and resumes
+// every timeline whose delay has elapsed (in deadline order); notifyInput and
+// notifyNodeEntered resume timelines waiting on those events. Suspended
+// timelines cost a heap slot or a waiter entry, both reused, so steady-state
+// steps allocate nothing.
+class TimelineScheduler {
+private:
+    struct NodeWaiter {
+        string_view nodeId;          // Caller's ID, see waitForNode
+        coroutine_handle<> handle;
+    };
+
+    FrameArena arena;                         // Declared first: frames are destroyed before it
+    ArrayList<Timeline::Handle> running;
+    TimerHeap<coroutine_handle<>> timers;
+    ArrayList<coroutine_handle<>> inputWaiters;
+    ArrayList<NodeWaiter> nodeWaiters;
+    double clock;
+
+    // Handles woken by one event, resumed after the waiter list is updated. A
+    // resumed timeline may raise another event (entering a node) re-entrantly,
+    // so each nesting level has its own buffer; buffers keep their capacity.
+    ArrayList<ArrayList<coroutine_handle<>>> wakeLists;
+    int wakeDepth;
+
+    ArrayList<coroutine_handle<>>& beginWake();
+    void finishWake();
+    void reapFinished();
+
+public:
+    TimelineScheduler();
+    ~TimelineScheduler();
+
+    TimelineScheduler(const TimelineScheduler&) = delete;
+    TimelineScheduler& operator=(const TimelineScheduler&) = delete;
+
+    // Take ownership of a timeline and run it to its first suspension
+    void start(Timeline timeline);
+    // Destroy every timeline, finished or not
+    void stopAll();
+
+    void update(float deltaTime);
+    void notifyInput();
+    void notifyNodeEntered(string_view nodeId);
+
+    [[nodiscard]] int getRunningCount() const { return running.length(); }
+    [[nodiscard]] double getClock() const { return clock; }
+    FrameArena& getArena() { return arena; }
+
+    struct DelayAwaiter {
+        TimelineScheduler& scheduler;
+        float seconds;
+
+        bool await_ready() const noexcept { return seconds <= 0.0f; }
+        void await_suspend(coroutine_handle<> handle) {
+            scheduler.timers.schedule(scheduler.clock + seconds, handle);
+        }
+        void await_resume() const noexcept {}
+    };
+
+    struct InputAwaiter {
+        TimelineScheduler& scheduler;
+
+        bool await_ready() const noexcept { return false; }
+        void await_suspend(coroutine_handle<> handle) { scheduler.inputWaiters.push(handle); }
+        void await_resume() const noexcept {}
+    };
+
+    struct NodeAwaiter {
+        TimelineScheduler& scheduler;
+        string_view nodeId;
+
+        bool await_ready() const noexcept { return false; }
+        void await_suspend(coroutine_handle<> handle) { scheduler.nodeWaiters.push(NodeWaiter{nodeId, handle}); }
+        void await_resume() const noexcept {}
+    };
+
+    // Awaitables; a delay of zero or less does not suspend
+    DelayAwaiter delay(float seconds) { return DelayAwaiter{*this, seconds}; }
+    InputAwaiter waitForInput() { return InputAwaiter{*this}; }
+    // nodeId must outlive the wait (a literal, or a string in the timeline's frame)
+    NodeAwaiter waitForNode(string_view nodeId) { return NodeAwaiter{*this, nodeId}; }
+};
+
+// Timelines a script can start by name (a choice's "timeline:<name>" effect).
+// Story content registers its timelines once at startup; the game state
+// starts them on its own scheduler.
+class TimelineRegistry {
+public:
+    using Factory = Timeline (*)(TimelineScheduler&, Player&);
+
+private:
+    HashTable<string, Factory> factories;
+
+public:
+    TimelineRegistry() = default;
+    TimelineRegistry(const TimelineRegistry&) = delete;
+    TimelineRegistry& operator=(const TimelineRegistry&) = delete;
+
+    // The registry scripts' timeline effects are looked up in
+    static TimelineRegistry& global();
+
+    void add(const string& name, Factory factory) { factories.insert(name, factory); }
+
+    // Start the named timeline on scheduler; false if no timeline has that name
+    bool start(string_view name, TimelineScheduler& scheduler, Player& player) const;
+};
+
+// Frame layout: [arena pointer, padded to max alignment][coroutine frame]
+namespace TimelineFrame {
+    constexpr size_t HEADER_SIZE = alignof(max_align_t) > sizeof(FrameArena*) ? alignof(max_align_t) : sizeof(FrameArena*);
+}
+
+template <class... Args>
+void* Timeline::promise_type::operator new(size_t size, TimelineScheduler& scheduler, Args&...) {
+    FrameArena& arena = scheduler.getArena();
+    void* block = arena.allocate(size + TimelineFrame::HEADER_SIZE);
+    *static_cast<FrameArena**>(block) = &arena;
+    return static_cast<unsigned char*>(block) + TimelineFrame::HEADER_SIZE;
+}
+
+inline void Timeline::promise_type::operator delete(void* frame, size_t size) {
+    void* block = static_cast<unsigned char*>(frame) - TimelineFrame::HEADER_SIZE;
+    (*static_cast<FrameArena**>(block))->release(block, size + TimelineFrame::HEADER_SIZE);
+}
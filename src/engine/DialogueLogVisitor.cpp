@@ -3,7 +3,7 @@
 
 using namespace std;
 
-DialogueLogVisitor::DialogueLogVisitor() {
+DialogueLogVisitor::DialogueLogVisitor() : revision(0), generation(0) {
     // Constructor - starts with empty log
 }
 
@@ -11,6 +11,7 @@ DialogueLogVisitor::DialogueLogVisitor() {
 void DialogueLogVisitor::visit(Dialogue& dialogue) {
     // Log this dialogue entry to conversation history
     conversationLog.push(DialogueEntry(dialogue.speaker, dialogue.message));
+    revision++;
 
     cout << "[LOG] Logged dialogue from '" << dialogue.speaker
          << "' (total entries: " << conversationLog.length() << ")" << endl;
@@ -22,6 +22,8 @@ class DialogueLogVisitor : public Visitor {
 private:
     // SinglyLinkedList data structure: Stores all dialogue history
     SinglyLinkedList<DialogueEntry> conversationLog;
+    unsigned revision;   // Bumped by every change, so views can tell when to redraw
+    unsigned generation; // Bumped by clearLog, so views holding entries can tell they are gone
 
 public:
     DialogueLogVisitor();
@@ -33,9 +35,15 @@ public:
 
     // Access to conversation history
     const SinglyLinkedList<DialogueEntry>& getConversationLog() const { return conversationLog; }
-    SinglyLinkedList<DialogueEntry>& getConversationLog() { return conversationLog; }
+    SinglyLinkedList<DialogueEntry>& getConversationLog() { return conversationLog; }  // Edits here do not bump the revision
 
     // Query operations
     int getLogSize() const { return conversationLog.length(); }
-    void clearLog() { conversationLog.clear(); }
+    unsigned getRevision() const { return revision; }
+    unsigned getGeneration() const { return generation; }
+    void clearLog() {
+        conversationLog.clear();
+        revision++;
+        generation++;
+    }
 };
@@ -3,6 +3,7 @@
 #include <iostream>
 #include <algorithm>
 #include "game/Player.h"
+#include <cmath>
 #include <ctime>
 
 // Helper to convert string (UTF-8) to sf::String
@@ -11,18 +12,16 @@ sf::String to_sf_string(const string& s) {
 }
 
 DialogueRenderVisitor::DialogueRenderVisitor(sf::RenderWindow& win)
-    : window(win), baseCharacterInterval(sf::seconds(0.05f)), characterInterval(sf::seconds(0.05f)),
-      dialogueActive(false), selectedChoice(0), currentDialogue(nullptr), player(nullptr),
-      showInventory(false), showHistory(false), logVisitor(nullptr) {
+    : window(win), layout(font), messageWrapWidth(0), revealedCount(0), baseCharacterInterval(sf::seconds(0.05f)),
+      characterInterval(sf::seconds(0.05f)), dialogueActive(false), choiceTruncateWidth(0), selectedChoice(0),
+      currentDialogue(nullptr), player(nullptr), showInventory(false), showHistory(false), logVisitor(nullptr),
+      fastForwardHint("[Hold Space to fast-forward]"), continueHint("[Press Enter to continue]"), statsShown{}, inventoryRevisionShown(0),
+      historyRevisionShown(0), historyScrollShown(0), historyIndexedTail(nullptr), historyGenerationIndexed(0),
+      historyWrapWidth(0), historyScroll(0), historyViewHeight(0), historyFollow(true) {
     if (!font.openFromFile("assets/arial.ttf")) {
         cerr << "Error loading font" << endl;
     }
-
-    // Main dialogue text
-    text = new sf::Text(font);
-    text->setCharacterSize(24);
-    text->setFillColor(sf::Color::White);
-    text->setPosition({70, 380});
+    continueHintWidth = layout.measure(continueHint, 18);
 
     // Speaker name text
     speakerText = new sf::Text(font);
@@ -33,7 +32,6 @@ DialogueRenderVisitor::DialogueRenderVisitor(sf::RenderWindow& win)
 }
 
 DialogueRenderVisitor::~DialogueRenderVisitor() {
-    delete text;
     delete speakerText;
     clearChoices();
 }
@@ -50,23 +48,20 @@ void DialogueRenderVisitor::visit(Dialogue& dialogue) {
 
     // Wrap text to fit within window
     sf::Vector2u windowSize = window.getSize();
-    float maxTextWidth = static_cast<float>(windowSize.x) - 100.0f;
-    fullMessage = to_sf_string(wrapText(dialogue.message, maxTextWidth));
-    currentMessage.clear();
-    text->setString(currentMessage);
+    message = dialogue.message;
+    revealedCount = 0;
+    wrapMessage(static_cast<float>(windowSize.x) - 100.0f);
     elapsedTime = sf::Time::Zero;
     selectedChoice = 0;
 
     // Prepare choice text objects for rendering
-    auto it = dialogue.choices.getIterator();
-    auto endIt = it.end();
-    while(it != endIt) {
+    for (const Choice& choice : dialogue.choices) {
         auto* choiceText = new sf::Text(font);
         choiceText->setCharacterSize(20);
         choiceText->setFillColor(sf::Color::White);
-        choiceText->setString(to_sf_string(it.getCurrent()->getValue().text));
+        choiceStrings.push(to_sf_string(choice.text));
+        choiceText->setString(choiceStrings.getLast());
         choiceTexts.push(choiceText);
-        ++it;
     }
 }
 
@@ -80,12 +75,15 @@ void DialogueRenderVisitor::visit(Choice& choice) {
 void DialogueRenderVisitor::update(sf::Time deltaTime) {
     if (!dialogueActive) return;
 
-    // Animate text reveal
-    if (currentMessage.getSize() < fullMessage.getSize()) {
+    // Animate text reveal: every character due this frame at once, however
+    // fast the text speed
+    if (revealedCount < fullMessage.getSize()) {
         elapsedTime += deltaTime;
-        while (elapsedTime >= characterInterval) {
-            elapsedTime -= characterInterval;
-            nextCharacter();
+        if (characterInterval <= sf::Time::Zero) {
+            skipToEnd();
+        } else if (elapsedTime >= characterInterval) {
+            revealCharacters(static_cast<size_t>(elapsedTime / characterInterval));
+            elapsedTime = elapsedTime % characterInterval;
         }
     }
 
@@ -95,17 +93,22 @@ void DialogueRenderVisitor::update(sf::Time deltaTime) {
     }
 }
 
-void DialogueRenderVisitor::render() {
+void DialogueRenderVisitor::render(UIBatch& batch) {
     if (!dialogueActive) return;
 
     // Draw player stats panel first
-    drawStatsPanel();
+    drawStatsPanel(batch);
 
     // Get window size for responsive positioning
     sf::Vector2u windowSize = window.getSize();
     float windowWidth = static_cast<float>(windowSize.x);
     float windowHeight = static_cast<float>(windowSize.y);
 
+    // Re-wrap after a resize; wraps are memoized, so resizing back is a lookup
+    if (windowWidth - 100.0f != messageWrapWidth) {
+        wrapMessage(windowWidth - 100.0f);
+    }
+
     // Dialogue box settings
     float boxMargin = 20.0f;
     float boxWidth = windowWidth - (boxMargin * 2);
@@ -115,41 +118,28 @@ void DialogueRenderVisitor::render() {
     // Draw speaker name above dialogue box
     if (!currentSpeaker.isEmpty()) {
         speakerText->setPosition({boxMargin + 10, boxY - 40});
-        window.draw(*speakerText);
+        batch.addText(*speakerText);
     }
 
     // Draw dialogue background box
-    sf::RectangleShape dialogueBox({boxWidth, boxHeight});
-    dialogueBox.setPosition({boxMargin, boxY});
-    dialogueBox.setFillColor(sf::Color(0, 0, 0, 220));
-    dialogueBox.setOutlineColor(sf::Color(100, 150, 200, 200));
-    dialogueBox.setOutlineThickness(3);
-    window.draw(dialogueBox);
+    batch.addRect({boxMargin, boxY}, {boxWidth, boxHeight}, sf::Color(0, 0, 0, 220),
+                  3, sf::Color(100, 150, 200, 200));
 
-    // Update and draw text
-    text->setPosition({boxMargin + 30.0f, boxY + 20});
-    window.draw(*text);
+    // Draw the revealed prefix of the laid-out message
+    int revealedVertices = revealedCount > 0 ? messageVertexEnds[static_cast<int>(revealedCount) - 1] : 0;
+    batch.addGlyphs(font, MESSAGE_SIZE, messageVertices, revealedVertices, {boxMargin + 30.0f, boxY + 20});
 
     // Show fast-forward hint if text is still animating
-    if (currentMessage.getSize() < fullMessage.getSize()) {
-        sf::Text fastForwardHint(font);
-        fastForwardHint.setCharacterSize(16);
-        fastForwardHint.setFillColor(sf::Color(180, 180, 180));
-        fastForwardHint.setString("[Hold Space to fast-forward]");
-        fastForwardHint.setPosition({windowWidth - 280, boxY + boxHeight - 30});
-        window.draw(fastForwardHint);
+    if (revealedCount < fullMessage.getSize()) {
+        batch.addText(font, fastForwardHint, 16, {windowWidth - 280, boxY + boxHeight - 30},
+                      sf::Color(180, 180, 180));
     }
 
     // Draw choices or continue hint
-    if (currentMessage.getSize() == fullMessage.getSize()) {
+    if (revealedCount == fullMessage.getSize()) {
         if (choiceTexts.isEmpty()) {
-            sf::Text continueHint(font);
-            continueHint.setCharacterSize(18);
-            continueHint.setFillColor(sf::Color(220, 220, 220));
-            continueHint.setString("[Press Enter to continue]");
-            float hintX = (windowWidth - continueHint.getLocalBounds().size.x) / 2;
-            continueHint.setPosition({hintX, boxY + boxHeight - 35});
-            window.draw(continueHint);
+            float hintX = (windowWidth - continueHintWidth) / 2;
+            batch.addText(font, continueHint, 18, {hintX, boxY + boxHeight - 35}, sf::Color(220, 220, 220));
         } else {
             // Draw choices on the right side
             float choiceWidth = min(windowWidth * 0.40f, 450.0f);
@@ -168,6 +158,11 @@ void DialogueRenderVisitor::render() {
 
             float choiceStartY = boxY - 30;
 
+            float maxTextWidth = choiceWidth - 20;
+            if (maxTextWidth != choiceTruncateWidth) {
+                truncateChoices(maxTextWidth);
+            }
+
             for (int i = 0; i < choiceTexts.length(); ++i) {
                 float choiceY = choiceStartY - ((choiceTexts.length() - i) * (choiceHeight + choiceSpacing));
 
@@ -175,54 +170,41 @@ void DialogueRenderVisitor::render() {
                     choiceY = 20 + i * (choiceHeight + 5);
                 }
 
-                sf::RectangleShape choiceBox({choiceWidth, choiceHeight});
-                choiceBox.setPosition({choiceX, choiceY});
-
                 if (i == selectedChoice) {
-                    choiceBox.setFillColor(sf::Color(80, 120, 180, 200));
-                    choiceBox.setOutlineColor(sf::Color(150, 200, 255));
-                    choiceBox.setOutlineThickness(3);
+                    batch.addRect({choiceX, choiceY}, {choiceWidth, choiceHeight}, sf::Color(80, 120, 180, 200),
+                                  3, sf::Color(150, 200, 255));
                 } else {
-                    choiceBox.setFillColor(sf::Color(40, 40, 60, 180));
-                    choiceBox.setOutlineColor(sf::Color(100, 100, 120));
-                    choiceBox.setOutlineThickness(2);
+                    batch.addRect({choiceX, choiceY}, {choiceWidth, choiceHeight}, sf::Color(40, 40, 60, 180),
+                                  2, sf::Color(100, 100, 120));
                 }
-                window.draw(choiceBox);
 
                 sf::Text* choiceText = choiceTexts[i];
                 choiceText->setPosition({choiceX + 10, choiceY + 4});
-
-                sf::String originalString = choiceText->getString();
-                float maxTextWidth = choiceWidth - 20;
-
-                if (choiceText->getLocalBounds().size.x > maxTextWidth) {
-                    sf::String truncatedString = originalString;
-                    while (truncatedString.getSize() > 3) {
-                        truncatedString.erase(truncatedString.getSize() - 1);
-                        choiceText->setString(truncatedString + "...");
-                        if (choiceText->getLocalBounds().size.x <= maxTextWidth) {
-                            break;
-                        }
-                    }
-                }
-                window.draw(*choiceText);
+                batch.addText(*choiceText);
             }
         }
     }
 
     // Draw optional panels
     if (showInventory) {
-        drawInventoryPanel();
+        drawInventoryPanel(batch);
     }
 
     if (showHistory) {
-        drawHistoryPanel();
+        drawHistoryPanel(batch);
     }
 }
 
 void DialogueRenderVisitor::handleInput(const sf::Event& event) {
     if (!dialogueActive) return;
 
+    if (const auto* wheelScrolled = event.getIf<sf::Event::MouseWheelScrolled>()) {
+        if (showHistory && wheelScrolled->wheel == sf::Mouse::Wheel::Vertical) {
+            scrollHistory(-wheelScrolled->delta * HISTORY_LINE_HEIGHT * 3);
+        }
+        return;
+    }
+
     if (const auto* keyPressed = event.getIf<sf::Event::KeyPressed>()) {
         if (keyPressed->code == sf::Keyboard::Key::I) {
             toggleInventoryView();
@@ -234,14 +216,32 @@ void DialogueRenderVisitor::handleInput(const sf::Event& event) {
             return;
         }
 
+        // Scroll the history view while it is open
+        if (showHistory) {
+            float page = max(HISTORY_LINE_HEIGHT, historyViewHeight - HISTORY_LINE_HEIGHT);
+            if (keyPressed->code == sf::Keyboard::Key::PageUp) {
+                scrollHistory(-page);
+                return;
+            } else if (keyPressed->code == sf::Keyboard::Key::PageDown) {
+                scrollHistory(page);
+                return;
+            } else if (keyPressed->code == sf::Keyboard::Key::Home) {
+                scrollHistory(-historyScroll);
+                return;
+            } else if (keyPressed->code == sf::Keyboard::Key::End) {
+                historyFollow = true;
+                return;
+            }
+        }
+
         if (keyPressed->code == sf::Keyboard::Key::Space) {
-            if (currentMessage.getSize() < fullMessage.getSize()) {
+            if (revealedCount < fullMessage.getSize()) {
                 skipToEnd();
                 return;
             }
         }
 
-        if (currentMessage.getSize() < fullMessage.getSize()) return;
+        if (revealedCount < fullMessage.getSize()) return;
 
         if (choiceTexts.isEmpty() && keyPressed->code == sf::Keyboard::Key::Enter) {
             dialogueActive = false;
@@ -258,16 +258,13 @@ void DialogueRenderVisitor::handleInput(const sf::Event& event) {
     }
 }
 
-void DialogueRenderVisitor::nextCharacter() {
-    if (currentMessage.getSize() < fullMessage.getSize()) {
-        currentMessage += static_cast<char32_t>(fullMessage[currentMessage.getSize()]);
-        text->setString(currentMessage);
-    }
+void DialogueRenderVisitor::revealCharacters(size_t count) {
+    revealedCount = min(revealedCount + count, fullMessage.getSize());
 }
 
 void DialogueRenderVisitor::selectChoice(int index) {
     if (currentDialogue && index < currentDialogue->choices.length()) {
-        currentDialogue->choices.get(index)->getValue().accept(*this);
+        currentDialogue->choices[index].accept(*this);
     }
 }
 
@@ -275,80 +272,102 @@ void DialogueRenderVisitor::clearChoices() {
     while (!choiceTexts.isEmpty()) {
         delete choiceTexts.pop();
     }
+    choiceStrings.clear();
+    choiceTruncateWidth = 0;
 }
 
-string DialogueRenderVisitor::wrapText(const string& text, float maxWidth) {
-    sf::String sfText = to_sf_string(text);
-    string result;
-    sf::String currentLine;
-    sf::String word;
-
-    sf::Text tempText(font);
-    tempText.setCharacterSize(24);
-
-    for (size_t idx = 0; idx < sfText.getSize(); ++idx) {
-        char32_t c = sfText[idx];
-        if (c == ' ' || c == '\n') {
-            sf::String testLine = currentLine;
-            if (!testLine.isEmpty()) {
-                testLine += ' ';
-            }
-            testLine += word;
-
-            tempText.setString(testLine);
-            if (tempText.getLocalBounds().size.x > maxWidth && !currentLine.isEmpty()) {
-                result += currentLine.toAnsiString() + "\n";
-                currentLine = word;
-            } else {
-                currentLine = testLine;
-            }
-
-            if (c == '\n') {
-                result += currentLine.toAnsiString();
-                currentLine.clear();
-            }
+// Wrap message to maxWidth and lay out its glyphs once, keeping the number of
+// characters revealed (wrapping only turns spaces into line breaks, so the
+// revealed prefix lines up)
+void DialogueRenderVisitor::wrapMessage(float maxWidth) {
+    fullMessage = layout.wrap(message, MESSAGE_SIZE, maxWidth).text;
+    messageWrapWidth = maxWidth;
+    messageVertices.clear();
+    messageVertexEnds.clear();
+    UIBatch::layoutText(font, fullMessage, MESSAGE_SIZE, {0.0f, 0.0f}, sf::Color::White, false, messageVertices,
+                        &messageVertexEnds);
+    revealedCount = min(revealedCount, fullMessage.getSize());
+}
 
-            word.clear();
-        } else {
-            word += c;
-        }
+// Fit each choice to maxWidth once per width, not every frame
+void DialogueRenderVisitor::truncateChoices(float maxWidth) {
+    for (int i = 0; i < choiceTexts.length(); ++i) {
+        choiceTexts[i]->setString(layout.truncate(choiceStrings[i], choiceTexts[i]->getCharacterSize(), maxWidth));
     }
+    choiceTruncateWidth = maxWidth;
+}
 
-    sf::String testLine = currentLine;
-    if (!testLine.isEmpty()) {
-        testLine += ' ';
+// Retained panel: rebuild into the panel's texture only when changed (or on
+// first use), then blit. Translucent shapes cleared onto transparent leave the
+// texture premultiplied by alpha, so the blit must not multiply by alpha again.
+// Panels drawn straight to the window flush the batch first to stay on top.
+void DialogueRenderVisitor::drawPanel(UIBatch& batch, RetainedPanel& panel, bool changed, sf::Vector2f position,
+                                      sf::Vector2f size, PanelBuilder build) {
+    if (size.x <= 0 || size.y <= 0) {
+        return; // Window too small to show the panel
+    }
+    if (panel.disabled) {
+        batch.flush(window);
+        (this->*build)(window, position, size);
+        return;
     }
-    testLine += word;
 
-    tempText.setString(testLine);
-    if (tempText.getLocalBounds().size.x > maxWidth && !currentLine.isEmpty()) {
-        result += currentLine.toAnsiString() + "\n";
-        currentLine = word;
-    } else {
-        currentLine = testLine;
+    sf::Vector2u textureSize(static_cast<unsigned>(ceil(size.x + 2 * PANEL_PADDING)),
+                             static_cast<unsigned>(ceil(size.y + 2 * PANEL_PADDING)));
+    if (panel.texture.getSize() != textureSize) {
+        if (!panel.texture.resize(textureSize)) {
+            cerr << "Cannot create panel texture, drawing panels every frame" << endl;
+            panel.disabled = true;
+            batch.flush(window);
+            (this->*build)(window, position, size);
+            return;
+        }
+        changed = true;
     }
 
-    if (!currentLine.isEmpty()) {
-        result += currentLine.toAnsiString();
+    if (changed || !panel.drawn) {
+        panel.texture.clear(sf::Color::Transparent);
+        (this->*build)(panel.texture, {PANEL_PADDING, PANEL_PADDING}, size);
+        panel.texture.display();
+        panel.drawn = true;
     }
 
-    return result;
+    batch.addTexture(panel.texture.getTexture(), {position.x - PANEL_PADDING, position.y - PANEL_PADDING},
+                     sf::BlendMode(sf::BlendMode::Factor::One, sf::BlendMode::Factor::OneMinusSrcAlpha));
 }
 
-void DialogueRenderVisitor::drawStatsPanel() {
+void DialogueRenderVisitor::drawStatsPanel(UIBatch& batch) {
     if (!player) return;
 
-    float panelX = 10.0f;
-    float panelY = 10.0f;
-    float panelWidth = 300.0f;
-    float panelHeight = 280.0f;
+    // Everything the panel shows; comparing is cheaper than drawing
+    const auto& stats = player->getStats();
+    const auto& inventory = player->getInventory();
+    array<int, 14> shown = {
+        stats.getCurrentHealth(), stats.getMaxHealth(), stats.getCurrentMana(), stats.getMaxMana(),
+        stats.getLevel(), stats.getExperience(), stats.getStrength(), stats.getDefense(),
+        stats.getIntelligence(), stats.getAgility(), inventory.getGold(), inventory.getItemCount(),
+        inventory.getCurrentWeight(), inventory.getMaxWeight()
+    };
+    bool changed = shown != statsShown || stats.getName() != statsNameShown;
+    if (changed) {
+        statsShown = shown;
+        statsNameShown = stats.getName();
+    }
+    drawPanel(batch, statsPanel, changed, {10.0f, 10.0f}, {300.0f, 280.0f}, &DialogueRenderVisitor::buildStatsPanel);
+}
+
+void DialogueRenderVisitor::buildStatsPanel(sf::RenderTarget& target, sf::Vector2f origin, sf::Vector2f size) {
+    float panelX = origin.x;
+    float panelY = origin.y;
+    float panelWidth = size.x;
+    float panelHeight = size.y;
 
     sf::RectangleShape panel({panelWidth, panelHeight});
     panel.setPosition({panelX, panelY});
     panel.setFillColor(sf::Color(0, 0, 0, 200));
     panel.setOutlineColor(sf::Color(100, 150, 200, 200));
     panel.setOutlineThickness(2);
-    window.draw(panel);
+    target.draw(panel);
 
     const auto& stats = player->getStats();
     const auto& inventory = player->getInventory();
@@ -362,7 +381,7 @@ void DialogueRenderVisitor::drawStatsPanel() {
     playerName.setStyle(sf::Text::Bold);
     playerName.setString(to_sf_string(stats.getName()));
     playerName.setPosition({panelX + 10.0f, currentY});
-    window.draw(playerName);
+    target.draw(playerName);
     currentY += lineHeight + 5.0f;
 
     sf::Text healthLabel(font);
@@ -370,19 +389,19 @@ void DialogueRenderVisitor::drawStatsPanel() {
     healthLabel.setFillColor(sf::Color::White);
     healthLabel.setString("Health: " + to_string(stats.getCurrentHealth()) + "/" + to_string(stats.getMaxHealth()));
     healthLabel.setPosition({panelX + 10.0f, currentY});
-    window.draw(healthLabel);
+    target.draw(healthLabel);
 
     float barWidth = panelWidth - 20.0f;
     float healthPercent = static_cast<float>(stats.getCurrentHealth()) / stats.getMaxHealth();
     sf::RectangleShape healthBarBg({barWidth, 8.0f});
     healthBarBg.setPosition({panelX + 10.0f, currentY + lineHeight + 2.0f});
     healthBarBg.setFillColor(sf::Color(50, 50, 50));
-    window.draw(healthBarBg);
+    target.draw(healthBarBg);
 
     sf::RectangleShape healthBar({barWidth * healthPercent, 8.0f});
     healthBar.setPosition({panelX + 10.0f, currentY + lineHeight + 2.0f});
     healthBar.setFillColor(sf::Color(200, 50, 50));
-    window.draw(healthBar);
+    target.draw(healthBar);
     currentY += lineHeight + 12.0f;
 
     sf::Text manaLabel(font);
@@ -390,18 +409,18 @@ void DialogueRenderVisitor::drawStatsPanel() {
     manaLabel.setFillColor(sf::Color::White);
     manaLabel.setString("Mana: " + to_string(stats.getCurrentMana()) + "/" + to_string(stats.getMaxMana()));
     manaLabel.setPosition({panelX + 10.0f, currentY});
-    window.draw(manaLabel);
+    target.draw(manaLabel);
 
     float manaPercent = static_cast<float>(stats.getCurrentMana()) / stats.getMaxMana();
     sf::RectangleShape manaBarBg({barWidth, 8.0f});
     manaBarBg.setPosition({panelX + 10.0f, currentY + lineHeight + 2.0f});
     manaBarBg.setFillColor(sf::Color(50, 50, 50));
-    window.draw(manaBarBg);
+    target.draw(manaBarBg);
 
     sf::RectangleShape manaBar({barWidth * manaPercent, 8.0f});
     manaBar.setPosition({panelX + 10.0f, currentY + lineHeight + 2.0f});
     manaBar.setFillColor(sf::Color(50, 100, 200));
-    window.draw(manaBar);
+    target.draw(manaBar);
     currentY += lineHeight + 12.0f;
 
     sf::Text statsLabel(font);
@@ -409,7 +428,7 @@ void DialogueRenderVisitor::drawStatsPanel() {
     statsLabel.setFillColor(sf::Color(180, 180, 180));
     statsLabel.setString("LVL: " + to_string(stats.getLevel()) + " | XP: " + to_string(stats.getExperience()));
     statsLabel.setPosition({panelX + 10.0f, currentY});
-    window.draw(statsLabel);
+    target.draw(statsLabel);
     currentY += lineHeight;
 
     sf::Text combatStats(font);
@@ -418,7 +437,7 @@ void DialogueRenderVisitor::drawStatsPanel() {
     combatStats.setString(to_sf_string("STR: " + to_string(stats.getStrength()) + " | DEF: " + to_string(stats.getDefense()) +
                          "\nINT: " + to_string(stats.getIntelligence()) + " | AGI: " + to_string(stats.getAgility())));
     combatStats.setPosition({panelX + 10.0f, currentY});
-    window.draw(combatStats);
+    target.draw(combatStats);
     currentY += lineHeight * 2.2f;
 
     sf::Text goldText(font);
@@ -426,7 +445,7 @@ void DialogueRenderVisitor::drawStatsPanel() {
     goldText.setFillColor(sf::Color(255, 215, 0));
     goldText.setString("Gold: " + to_string(inventory.getGold()));
     goldText.setPosition({panelX + 10.0f, currentY});
-    window.draw(goldText);
+    target.draw(goldText);
     currentY += lineHeight;
 
     sf::Text inventoryText(font);
@@ -435,26 +454,33 @@ void DialogueRenderVisitor::drawStatsPanel() {
     inventoryText.setString(to_sf_string("Items: " + to_string(inventory.getItemCount()) + " | Weight: " +
                            to_string(inventory.getCurrentWeight()) + "/" + to_string(inventory.getMaxWeight())));
     inventoryText.setPosition({panelX + 10.0f, currentY});
-    window.draw(inventoryText);
+    target.draw(inventoryText);
 }
 
-void DialogueRenderVisitor::drawInventoryPanel() {
+void DialogueRenderVisitor::drawInventoryPanel(UIBatch& batch) {
     if (!player) return;
 
-    sf::Vector2u windowSize = window.getSize();
-    float windowWidth = static_cast<float>(windowSize.x);
+    unsigned revision = player->getInventory().getRevision();
+    bool changed = revision != inventoryRevisionShown;
+    inventoryRevisionShown = revision;
+
+    float windowWidth = static_cast<float>(window.getSize().x);
+    drawPanel(batch, inventoryPanel, changed, {windowWidth - 350.0f, 10.0f}, {340.0f, 500.0f},
+              &DialogueRenderVisitor::buildInventoryPanel);
+}
 
-    float panelX = windowWidth - 350.0f;
-    float panelY = 10.0f;
-    float panelWidth = 340.0f;
-    float panelHeight = 500.0f;
+void DialogueRenderVisitor::buildInventoryPanel(sf::RenderTarget& target, sf::Vector2f origin, sf::Vector2f size) {
+    float panelX = origin.x;
+    float panelY = origin.y;
+    float panelWidth = size.x;
+    float panelHeight = size.y;
 
     sf::RectangleShape panel({panelWidth, panelHeight});
     panel.setPosition({panelX, panelY});
     panel.setFillColor(sf::Color(0, 0, 0, 220));
     panel.setOutlineColor(sf::Color(150, 100, 200, 200));
     panel.setOutlineThickness(2);
-    window.draw(panel);
+    target.draw(panel);
 
     sf::Text inventoryTitle(font);
     inventoryTitle.setCharacterSize(18);
@@ -462,7 +488,7 @@ void DialogueRenderVisitor::drawInventoryPanel() {
     inventoryTitle.setStyle(sf::Text::Bold);
     inventoryTitle.setString("INVENTORY (Press I to close)");
     inventoryTitle.setPosition({panelX + 10.0f, panelY + 10.0f});
-    window.draw(inventoryTitle);
+    target.draw(inventoryTitle);
 
     float currentY = panelY + 35.0f;
     float lineHeight = 18.0f;
@@ -477,7 +503,7 @@ void DialogueRenderVisitor::drawInventoryPanel() {
         emptyText.setFillColor(sf::Color(150, 150, 150));
         emptyText.setString("No items yet");
         emptyText.setPosition({panelX + 15.0f, currentY + 50.0f});
-        window.draw(emptyText);
+        target.draw(emptyText);
     } else {
         auto& itemsList = player->getInventory().getItems();
         auto it = itemsList.getIterator();
@@ -492,7 +518,7 @@ void DialogueRenderVisitor::drawInventoryPanel() {
             itemText.setFillColor(sf::Color::White);
 
             string typeStr;
-            switch (item.type) {
+            switch (item.getType()) {
                 case ItemType::WEAPON: typeStr = "[W] "; break;
                 case ItemType::ARMOR: typeStr = "[A] "; break;
                 case ItemType::POTION: typeStr = "[P] "; break;
@@ -501,7 +527,7 @@ void DialogueRenderVisitor::drawInventoryPanel() {
                 default: typeStr = "[*] "; break;
             }
 
-            sf::String displayText = to_sf_string(typeStr + item.name);
+            sf::String displayText = to_sf_string(typeStr + item.getName());
             if (displayText.getSize() > 40) {
                 displayText.erase(37, displayText.getSize() - 37);
                 displayText += "...";
@@ -509,14 +535,14 @@ void DialogueRenderVisitor::drawInventoryPanel() {
 
             itemText.setString(displayText);
             itemText.setPosition({panelX + 10.0f, currentY});
-            window.draw(itemText);
+            target.draw(itemText);
 
             sf::Text valueText(font);
             valueText.setCharacterSize(12);
             valueText.setFillColor(sf::Color(255, 215, 0));
-            valueText.setString(to_string(item.value));
+            valueText.setString(to_string(item.getValue()));
             valueText.setPosition({panelX + panelWidth - 50.0f, currentY});
-            window.draw(valueText);
+            target.draw(valueText);
 
             currentY += lineHeight;
             itemsDrawn++;
@@ -530,7 +556,7 @@ void DialogueRenderVisitor::drawInventoryPanel() {
         scrollHint.setFillColor(sf::Color(150, 150, 150));
         scrollHint.setString("... and " + to_string(itemCount - maxItemsVisible) + " more");
         scrollHint.setPosition({panelX + 10.0f, currentY});
-        window.draw(scrollHint);
+        target.draw(scrollHint);
     }
 
     sf::Text weightInfo(font);
@@ -538,10 +564,10 @@ void DialogueRenderVisitor::drawInventoryPanel() {
     weightInfo.setFillColor(sf::Color(180, 180, 180));
     weightInfo.setString("Weight: " + to_string(inventory.getCurrentWeight()) + "/" + to_string(inventory.getMaxWeight()));
     weightInfo.setPosition({panelX + 10.0f, panelY + panelHeight - 25.0f});
-    window.draw(weightInfo);
+    target.draw(weightInfo);
 }
 
-void DialogueRenderVisitor::drawHistoryPanel() {
+void DialogueRenderVisitor::drawHistoryPanel(UIBatch& batch) {
     // Check if we have access to the log visitor
     if (!logVisitor) {
         return; // No log visitor available, cannot display history
@@ -551,17 +577,76 @@ void DialogueRenderVisitor::drawHistoryPanel() {
     float windowWidth = static_cast<float>(windowSize.x);
     float windowHeight = static_cast<float>(windowSize.y);
 
-    float panelWidth = min(800.0f, windowWidth - 40.0f);
-    float panelHeight = min(600.0f, windowHeight - 80.0f);
-    float panelX = (windowWidth - panelWidth) / 2.0f;
-    float panelY = (windowHeight - panelHeight) / 2.0f;
+    sf::Vector2f size(min(800.0f, windowWidth - 40.0f), min(600.0f, windowHeight - 80.0f));
+    if (size.x <= 0 || size.y <= 0) {
+        return; // Window too small to show the panel
+    }
+
+    // Index new entries and settle the scroll offset before deciding to redraw
+    indexHistory(size.x - 40.0f);
+    historyViewHeight = max(0.0f, size.y - 80.0f);
+    float maxScroll = max(0.0f, historyRowTops.getLast() - historyViewHeight);
+    historyScroll = historyFollow ? maxScroll : min(historyScroll, maxScroll);
+    historyFollow = historyScroll >= maxScroll;
+
+    unsigned revision = logVisitor->getRevision();
+    bool changed = revision != historyRevisionShown || size != historySizeShown || historyScroll != historyScrollShown;
+    historyRevisionShown = revision;
+    historySizeShown = size;
+    historyScrollShown = historyScroll;
+
+    drawPanel(batch, historyPanel, changed, {(windowWidth - size.x) / 2.0f, (windowHeight - size.y) / 2.0f}, size,
+              &DialogueRenderVisitor::buildHistoryPanel);
+}
+
+// Add rows for log entries not indexed yet, starting over after clearLog or a
+// width change (between clears the log only grows at the back)
+void DialogueRenderVisitor::indexHistory(float wrapWidth) {
+    const SinglyLinkedList<DialogueEntry>& conversationLog = logVisitor->getConversationLog();
+    if (historyRowTops.isEmpty() || wrapWidth != historyWrapWidth ||
+        logVisitor->getGeneration() != historyGenerationIndexed ||
+        conversationLog.length() < historyEntries.length()) {
+        historyEntries.clear();
+        historyRowTops.clear();
+        historyRowTops.push(0.0f);
+        historyIndexedTail = nullptr;
+        historyWrapWidth = wrapWidth;
+        historyGenerationIndexed = logVisitor->getGeneration();
+    }
+    if (conversationLog.length() == historyEntries.length()) {
+        return;
+    }
+
+    SinglyLinkedNode<DialogueEntry>* node = historyIndexedTail ? historyIndexedTail->getNext()
+                                                               : conversationLog.getIterator().getCurrent();
+    while (node != &SinglyLinkedNode<DialogueEntry>::NIL) {
+        const DialogueEntry& entry = node->getValue();
+        int lineCount = layout.wrap(entry.message, 13, wrapWidth).lineCount;
+        historyEntries.push(&entry);
+        historyRowTops.push(historyRowTops.getLast() + HISTORY_LINE_HEIGHT * static_cast<float>(1 + max(lineCount, 1)) +
+                            HISTORY_ENTRY_GAP);
+        historyIndexedTail = node;
+        node = node->getNext();
+    }
+}
+
+void DialogueRenderVisitor::scrollHistory(float delta) {
+    historyScroll = max(0.0f, historyScroll + delta);
+    historyFollow = false;   // Resumed by drawHistoryPanel when this reaches the end
+}
+
+void DialogueRenderVisitor::buildHistoryPanel(sf::RenderTarget& target, sf::Vector2f origin, sf::Vector2f size) {
+    float panelX = origin.x;
+    float panelY = origin.y;
+    float panelWidth = size.x;
+    float panelHeight = size.y;
 
     sf::RectangleShape panel({panelWidth, panelHeight});
     panel.setPosition({panelX, panelY});
     panel.setFillColor(sf::Color(0, 0, 0, 240));
     panel.setOutlineColor(sf::Color(200, 150, 100, 200));
     panel.setOutlineThickness(3);
-    window.draw(panel);
+    target.draw(panel);
 
     sf::Text historyTitle(font);
     historyTitle.setCharacterSize(20);
@@ -569,85 +654,73 @@ void DialogueRenderVisitor::drawHistoryPanel() {
     historyTitle.setStyle(sf::Text::Bold);
     historyTitle.setString("CONVERSATION HISTORY (Press H to close)");
     historyTitle.setPosition({panelX + 15.0f, panelY + 10.0f});
-    window.draw(historyTitle);
-
-    // Get the conversation log from the log visitor
-    const SinglyLinkedList<DialogueEntry>& conversationLog = logVisitor->getConversationLog();
+    target.draw(historyTitle);
 
-    float currentY = panelY + 45.0f;
-    float lineHeight = 18.0f;
-    float maxContentHeight = panelHeight - 60.0f;
+    float contentY = panelY + 45.0f;
 
     // Check if log is empty
-    if (conversationLog.isEmpty()) {
+    if (historyEntries.isEmpty()) {
         sf::Text emptyText(font);
         emptyText.setCharacterSize(14);
         emptyText.setFillColor(sf::Color(150, 150, 150));
         emptyText.setString("No conversation history yet");
-        emptyText.setPosition({panelX + 20.0f, currentY + 50.0f});
-        window.draw(emptyText);
+        emptyText.setPosition({panelX + 20.0f, contentY + 50.0f});
+        target.draw(emptyText);
+        return;
+    }
+    if (historyViewHeight <= 0) {
         return;
     }
 
-    // Iterate through the conversation log and render each entry
-    auto it = const_cast<SinglyLinkedList<DialogueEntry>&>(conversationLog).getIterator();
-    auto endIt = it.end();
-    int entryCount = 0;
-    int maxEntries = static_cast<int>(maxContentHeight / (lineHeight * 3.5f)); // Each entry takes ~3-4 lines
-
-    while (it != endIt && entryCount < maxEntries) {
-        const DialogueEntry& entry = it.getCurrent()->getValue();
-
-        // Draw speaker name
-        sf::Text speakerNameText(font);
-        speakerNameText.setCharacterSize(14);
-        speakerNameText.setFillColor(sf::Color(255, 215, 0));
-        speakerNameText.setStyle(sf::Text::Bold);
-        speakerNameText.setString(to_sf_string(entry.speaker + ":"));
-        speakerNameText.setPosition({panelX + 15.0f, currentY});
-        window.draw(speakerNameText);
-        currentY += lineHeight;
-
-        // Draw message (wrapped if necessary)
-        string wrappedMessage = wrapText(entry.message, panelWidth - 40.0f);
-        sf::Text messageText(font);
-        messageText.setCharacterSize(13);
-        messageText.setFillColor(sf::Color(220, 220, 220));
-        messageText.setString(to_sf_string(wrappedMessage));
-        messageText.setPosition({panelX + 15.0f, currentY});
-        window.draw(messageText);
-
-        // Calculate how many lines this message takes
-        int numLines = 1;
-        for (char c : wrappedMessage) {
-            if (c == '\n') numLines++;
-        }
-        currentY += lineHeight * numLines + 10.0f; // Add spacing between entries
-
-        // Check if we're running out of space
-        if (currentY + lineHeight * 4 > panelY + panelHeight - 10.0f) {
-            break; // Stop rendering to avoid overflow
-        }
-
-        ++it;
-        entryCount++;
+    // First row reaching into the view, by binary search over the row tops;
+    // rows are added until one starts below the view
+    const float* rowTops = historyRowTops.getData();
+    int first = static_cast<int>(upper_bound(rowTops, rowTops + historyRowTops.length(), historyScroll) - rowTops) - 1;
+    int last = first;
+    while (last < historyEntries.length() && rowTops[last] < historyScroll + historyViewHeight) {
+        const DialogueEntry& entry = *historyEntries[last];
+        float rowY = contentY + rowTops[last] - historyScroll;
+        historyBatch.addText(font, to_sf_string(entry.speaker + ":"), 14, {panelX + 15.0f, rowY},
+                             sf::Color(255, 215, 0), true);
+        // Wraps are memoized, so redrawing the same rows is a lookup
+        historyBatch.addText(font, layout.wrap(entry.message, 13, historyWrapWidth).text, 13,
+                             {panelX + 15.0f, rowY + HISTORY_LINE_HEIGHT}, sf::Color(220, 220, 220));
+        ++last;
     }
 
-    // Show indicator if there are more entries
-    int totalEntries = conversationLog.length();
-    if (entryCount < totalEntries) {
-        sf::Text moreText(font);
-        moreText.setCharacterSize(12);
-        moreText.setFillColor(sf::Color(150, 150, 150));
-        moreText.setString("... and " + to_string(totalEntries - entryCount) + " more entries");
-        moreText.setPosition({panelX + 15.0f, panelY + panelHeight - 30.0f});
-        window.draw(moreText);
+    // Rows cut by the edges of the view are clipped to it
+    sf::Vector2f targetSize(static_cast<float>(target.getSize().x), static_cast<float>(target.getSize().y));
+    sf::FloatRect viewArea({panelX, contentY}, {panelWidth, historyViewHeight});
+    sf::View clip(viewArea);
+    clip.setViewport(sf::FloatRect({viewArea.position.x / targetSize.x, viewArea.position.y / targetSize.y},
+                                   {viewArea.size.x / targetSize.x, viewArea.size.y / targetSize.y}));
+    sf::View previousView = target.getView();
+    target.setView(clip);
+    historyBatch.flush(target);
+    target.setView(previousView);
+
+    // Scroll bar, when the entries do not fit
+    float contentHeight = historyRowTops.getLast();
+    if (contentHeight > historyViewHeight) {
+        float thumbHeight = max(20.0f, historyViewHeight * historyViewHeight / contentHeight);
+        float thumbY = contentY + (historyViewHeight - thumbHeight) * historyScroll / (contentHeight - historyViewHeight);
+        sf::RectangleShape thumb({4.0f, thumbHeight});
+        thumb.setPosition({panelX + panelWidth - 12.0f, thumbY});
+        thumb.setFillColor(sf::Color(200, 150, 100, 160));
+        target.draw(thumb);
     }
+
+    sf::Text positionText(font);
+    positionText.setCharacterSize(12);
+    positionText.setFillColor(sf::Color(150, 150, 150));
+    positionText.setString("Entries " + to_string(first + 1) + "-" + to_string(last) + " of " +
+                           to_string(historyEntries.length()) + "   (PgUp/PgDn, Home/End or mouse wheel to scroll)");
+    positionText.setPosition({panelX + 15.0f, panelY + panelHeight - 30.0f});
+    target.draw(positionText);
 }
 
 void DialogueRenderVisitor::skipToEnd() {
-    currentMessage = fullMessage;
-    text->setString(currentMessage);
+    revealedCount = fullMessage.getSize();
 }
 
 void DialogueRenderVisitor::setTextSpeed(float speed) {
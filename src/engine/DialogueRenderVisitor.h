@@ -2,13 +2,18 @@
 
 #include "Visitor.h"
 #include "dialogue/Dialogue.h"
-#include "List.h"
+#include "ArrayList.h"
+#include "TextLayout.h"
+#include "UIBatch.h"
+#include "SinglyLinkedNode.h"
 #include <SFML/Graphics.hpp>
+#include <array>
 #include <string>
 #include "game/Player.h"
 
 // Forward declaration to avoid circular dependency
 class DialogueLogVisitor;
+struct DialogueEntry;
 
 using namespace std;
 
@@ -17,18 +22,24 @@ private:
     // SFML rendering state
     sf::RenderWindow& window;
     sf::Font font;
-    sf::Text* text;
+    TextLayout layout;          // Measures with font; declared after it
     sf::Text* speakerText;
     sf::String currentSpeaker;
-    sf::String fullMessage;
-    sf::String currentMessage;
+    string message;             // Unwrapped, re-wrapped when the window width changes
+    float messageWrapWidth;
+    sf::String fullMessage;     // Wrapped
+    ArrayList<sf::Vertex> messageVertices;   // Glyph quads of fullMessage, laid out once per wrap
+    ArrayList<int> messageVertexEnds;        // Entry i: vertices covering characters 0..i
+    size_t revealedCount;                    // Typewriter reveal: characters of fullMessage shown
     sf::Time characterInterval;
     sf::Time baseCharacterInterval;
     sf::Time elapsedTime;
 
     // UI state
     bool dialogueActive;
-    List<sf::Text*> choiceTexts;
+    ArrayList<sf::Text*> choiceTexts;
+    ArrayList<sf::String> choiceStrings;   // Untruncated choice text
+    float choiceTruncateWidth;             // Width choiceTexts were truncated to, 0 if not yet
     int selectedChoice;
     Dialogue* currentDialogue;
     Player* player;
@@ -36,6 +47,49 @@ private:
     bool showHistory;
     DialogueLogVisitor* logVisitor;
 
+    static constexpr unsigned MESSAGE_SIZE = 24;
+
+    // Fixed hints, built (and the centered one measured) once
+    sf::String fastForwardHint;
+    sf::String continueHint;
+    float continueHintWidth;
+
+    // Retained side panels: rebuilt into a texture only when what they show
+    // changes (player stats, inventory revision, log revision, size), blitted
+    // every frame otherwise
+    struct RetainedPanel {
+        sf::RenderTexture texture;
+        bool drawn = false;       // Texture holds the panel (cleared to force a rebuild)
+        bool disabled = false;    // Texture creation failed: draw to the window each frame
+    };
+    using PanelBuilder = void (DialogueRenderVisitor::*)(sf::RenderTarget&, sf::Vector2f, sf::Vector2f);
+    static constexpr float PANEL_PADDING = 3.0f;   // Room for outlines, which are drawn outside the panel
+
+    RetainedPanel statsPanel;
+    RetainedPanel inventoryPanel;
+    RetainedPanel historyPanel;
+    array<int, 14> statsShown;    // Values statsPanel was built from
+    string statsNameShown;
+    unsigned inventoryRevisionShown;
+    unsigned historyRevisionShown;
+    sf::Vector2f historySizeShown;
+    float historyScrollShown;
+
+    // Virtualized history: entries are indexed once (again only after the log
+    // is cleared or the wrap width changes), and the prefix sums of their row
+    // heights find the rows at the scroll offset, so only visible rows are drawn
+    static constexpr float HISTORY_LINE_HEIGHT = 18.0f;
+    static constexpr float HISTORY_ENTRY_GAP = 10.0f;
+    ArrayList<const DialogueEntry*> historyEntries;
+    ArrayList<float> historyRowTops;     // Row i spans [historyRowTops[i], historyRowTops[i + 1])
+    SinglyLinkedNode<DialogueEntry>* historyIndexedTail;   // Last indexed log node, null if none
+    unsigned historyGenerationIndexed;
+    float historyWrapWidth;
+    float historyScroll;                 // Content height above the view
+    float historyViewHeight;
+    bool historyFollow;                  // At the end: stay there as entries arrive
+    UIBatch historyBatch;                // Visible rows, drawn clipped to the view
+
 public:
     explicit DialogueRenderVisitor(sf::RenderWindow& window);
     ~DialogueRenderVisitor() override;
@@ -44,9 +98,9 @@ public:
     void visit(Dialogue& dialogue) override;
     void visit(Choice& choice) override;
 
-    // Rendering operations
+    // Rendering operations: render adds to batch, the caller flushes it
     void update(sf::Time deltaTime);
-    void render();
+    void render(UIBatch& batch);
 
     // UI State management
     void handleInput(const sf::Event& event);
@@ -54,24 +108,41 @@ public:
     void setTextSpeed(float speed);
     void toggleInventoryView() { showInventory = !showInventory; }
     void toggleHistoryView() { showHistory = !showHistory; }
+    void scrollHistory(float delta);
 
     // State queries
     bool isDialogueActive() const { return dialogueActive; }
     int getSelectedChoice() const { return selectedChoice; }
 
     // Player reference for stats/inventory display
-    void setPlayer(Player* player) { this->player = player; }
+    void setPlayer(Player* player) {
+        this->player = player;
+        statsPanel.drawn = inventoryPanel.drawn = false;
+    }
 
     // Log visitor reference for history display
-    void setLogVisitor(DialogueLogVisitor* logVisitor) { this->logVisitor = logVisitor; }
+    void setLogVisitor(DialogueLogVisitor* logVisitor) {
+        this->logVisitor = logVisitor;
+        historyPanel.drawn = false;
+        historyEntries.clear();
+        historyRowTops.clear();
+        historyIndexedTail = nullptr;
+    }
 
 private:
     // Helper methods for rendering different UI components
-    void nextCharacter();
+    void revealCharacters(size_t count);
     void selectChoice(int index);
     void clearChoices();
-    void drawStatsPanel();
-    void drawInventoryPanel();
-    void drawHistoryPanel();
-    string wrapText(const string& text, float maxWidth);
+    void drawPanel(UIBatch& batch, RetainedPanel& panel, bool changed, sf::Vector2f position, sf::Vector2f size,
+                   PanelBuilder build);
+    void drawStatsPanel(UIBatch& batch);
+    void drawInventoryPanel(UIBatch& batch);
+    void drawHistoryPanel(UIBatch& batch);
+    void buildStatsPanel(sf::RenderTarget& target, sf::Vector2f origin, sf::Vector2f size);
+    void buildInventoryPanel(sf::RenderTarget& target, sf::Vector2f origin, sf::Vector2f size);
+    void buildHistoryPanel(sf::RenderTarget& target, sf::Vector2f origin, sf::Vector2f size);
+    void indexHistory(float wrapWidth);
+    void wrapMessage(float maxWidth);
+    void truncateChoices(float maxWidth);
 };
@@ -37,14 +37,18 @@ void DialogueUI::displayDialogue(Dialogue& dialogue, bool enableDebug) {
     cout << "  - Debug visitor dialogue count: " << debugVisitor.getDialogueCount() << endl << endl;
 }
 
+void DialogueUI::refreshDialogue(Dialogue& dialogue) {
+    dialogue.accept(renderVisitor);
+}
+
 void DialogueUI::update(float dt) {
     // Delegate to render visitor for animation updates
     renderVisitor.update(sf::seconds(dt));
 }
 
-void DialogueUI::render() {
+void DialogueUI::render(UIBatch& batch) {
     // Delegate to render visitor for drawing
-    renderVisitor.render();
+    renderVisitor.render(batch);
 }
 
 void DialogueUI::handleInput(const sf::Event& event) {
@@ -24,9 +24,13 @@ public:
     // Process a dialogue node using multiple visitors
     void displayDialogue(Dialogue& dialogue, bool enableDebug = false);
 
+    // Show a new version of the node already displayed (e.g. after a hot
+    // reload): only the render visitor runs, the log is not extended
+    void refreshDialogue(Dialogue& dialogue);
+
     // Update and render operations
     void update(float dt);
-    void render();
+    void render(UIBatch& batch);
     void handleInput(const sf::Event& event);
 
     // State queries
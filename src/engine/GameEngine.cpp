@@ -1,7 +1,9 @@
 #include "GameEngine.h"
+#include <cstdlib>
 #include <iostream>
 #include "states/GameState.h"
 #include "AssetPaths.h"
+#include "game/StoryTimelines.h"
 
 using namespace std;
 
@@ -36,14 +38,46 @@ GameEngine::GameEngine() : currentState(nullptr), pendingState(nullptr), player(
 void GameEngine::loadDialogues() {
     // Create dialogue graph with player reference for stat modifications
     dialogueGraph = new DialogueGraph(player);
+    registerStoryTimelines(TimelineRegistry::global());
 
-    // Load main dialogue script file
-    string scriptPath = string(ASSETS_PATH) + "dialogues/script.txt";
-    if (dialogueGraph->loadFromFile(scriptPath)) {
+    // Load main dialogue script, through its compiled image when that is up to date
+    List<string> scripts;
+    scripts.push(string(ASSETS_PATH) + "dialogues/script.txt");
+    string imagePath = string(ASSETS_PATH) + "dialogues/script.dlgc";
+
+    // Hot reload patches parsed scripts, so it always loads the text
+    bool hotReload = getenv("DIALOGUE_HOT_RELOAD") != nullptr;
+
+    // Paged scripts keep node text on disk, cached up to DIALOGUE_PAGE_BUDGET_KB;
+    // an up-to-date image is read in place either way
+    const char* pageBudget = getenv("DIALOGUE_PAGE_BUDGET_KB");
+    if (pageBudget && !hotReload) {
+        dialogueGraph->setPageBudget(strtoull(pageBudget, nullptr, 10) * 1024);
+    }
+    bool loaded = hotReload ? dialogueGraph->loadFiles(scripts) : dialogueGraph->loadCompiled(imagePath, scripts);
+    if (loaded) {
         cout << "Dialogues loaded." << endl;
     } else {
         cerr << "Failed to load initial dialogue file!" << endl;
     }
+
+    if (hotReload && scriptWatcher.watchDirectory(string(ASSETS_PATH) + "dialogues")) {
+        cout << "Watching dialogue scripts for changes" << endl;
+    }
+}
+
+// Patch scripts saved since the last frame into the graph
+void GameEngine::reloadChangedScripts() {
+    changedScripts.clear();
+    scriptWatcher.poll(changedScripts);
+    for (const string& script : changedScripts) {
+        // A reload never ends the game: anything it throws is reported and skipped
+        try {
+            dialogueGraph->reloadFile(script);
+        } catch (const exception& e) {
+            cerr << script << ": reload failed (" << e.what() << ")" << endl;
+        }
+    }
 }
 
 // Load and play background music
@@ -114,6 +148,10 @@ void GameEngine::processEvents() {
 
 // Update game logic based on elapsed time
 void GameEngine::update(sf::Time deltaTime) {
+    if (scriptWatcher.isActive()) {
+        reloadChangedScripts();
+    }
+
     // Update current state with delta time
     if (currentState) {
         currentState->update(deltaTime.asSeconds());
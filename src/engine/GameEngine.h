@@ -4,6 +4,7 @@
 #include <SFML/Audio.hpp>
 #include <memory>
 #include "dialogue/DialogueGraph.h"
+#include "dialogue/ScriptWatcher.h"
 #include "game/Player.h"
 #include "game/Settings.h"
 #include "states/GameState.h"
@@ -23,6 +24,12 @@ private:
     // Core game systems
     Player player;
     DialogueGraph* dialogueGraph;
+
+    // Hot reload (DIALOGUE_HOT_RELOAD set): saved scripts are re-parsed and
+    // patched into the graph while the game runs
+    ScriptWatcher scriptWatcher;
+    ArrayList<string> changedScripts;
+
     Settings settings;
 
     // SFML: Background music player
@@ -53,4 +60,5 @@ private:
     // Initialization helpers
     void loadDialogues();
     void loadMusic();
+    void reloadChangedScripts();
 };
@@ -0,0 +1,160 @@
+#include "TextLayout.h"
+#include <algorithm>
+#include <cstring>
+
+TextLayout::TextLayout(const sf::Font& layoutFont, size_t cacheBudgetBytes)
+    : font(layoutFont), wrapCache(cacheBudgetBytes) {}
+
+float TextLayout::getAdvance(uint32_t codePoint, unsigned characterSize) {
+    uint64_t key = advanceKey(codePoint, characterSize);
+    if (const float* cached = advances.search(key)) {
+        return *cached;
+    }
+    float advance = font.getGlyph(codePoint, characterSize, false).advance;
+    advances.insert(key, advance);
+    return advance;
+}
+
+float TextLayout::getKerning(uint32_t first, uint32_t second, unsigned characterSize) {
+    uint64_t key = kerningKey(first, second, characterSize);
+    if (const float* cached = kernings.search(key)) {
+        return *cached;
+    }
+    float kerning = font.getKerning(first, second, characterSize);
+    kernings.insert(key, kerning);
+    return kerning;
+}
+
+float TextLayout::step(uint32_t previous, uint32_t c, unsigned characterSize) {
+    float kerning = previous ? getKerning(previous, c, characterSize) : 0.0f;
+    if (c == '\t') {
+        return kerning + getAdvance(' ', characterSize) * 4;
+    }
+    return kerning + getAdvance(c, characterSize);
+}
+
+float TextLayout::measure(const sf::String& text, unsigned characterSize) {
+    float width = 0.0f;
+    uint32_t previous = 0;
+    for (size_t i = 0; i < text.getSize(); ++i) {
+        width += step(previous, text[i], characterSize);
+        previous = text[i];
+    }
+    return width;
+}
+
+const WrappedText& TextLayout::wrap(string_view utf8, unsigned characterSize, float maxWidth) {
+    // Key: the text, then the size and the width's bit pattern
+    uint32_t widthBits;
+    memcpy(&widthBits, &maxWidth, sizeof(widthBits));
+    string key;
+    key.reserve(utf8.size() + 1 + 2 * sizeof(uint32_t));
+    key.append(utf8);
+    key += '\0';
+    key.append(reinterpret_cast<const char*>(&characterSize), sizeof(uint32_t));
+    key.append(reinterpret_cast<const char*>(&widthBits), sizeof(widthBits));
+
+    if (WrappedText* cached = wrapCache.get(key)) {
+        return *cached;
+    }
+
+    WrappedText result;
+    result.text = sf::String::fromUtf8(utf8.begin(), utf8.end());
+    sf::String& text = result.text;
+    size_t length = text.getSize();
+    result.lineCount = length > 0 ? 1 : 0;
+
+    // One pass over gap-then-word runs; lineWidth ends at the last word placed
+    float lineWidth = 0.0f;
+    uint32_t previous = 0;
+    bool lineEmpty = true;
+    size_t i = 0;
+    while (i < length) {
+        if (text[i] == '\n') {
+            result.width = max(result.width, lineWidth);
+            lineWidth = 0.0f;
+            previous = 0;
+            lineEmpty = true;
+            result.lineCount++;
+            ++i;
+            continue;
+        }
+
+        float extended = lineWidth;   // Line width with this gap and word
+        uint32_t last = previous;
+        while (i < length && text[i] == ' ') {
+            extended += step(last, ' ', characterSize);
+            last = ' ';
+            ++i;
+        }
+        size_t wordStart = i;
+        float wordWidth = 0.0f;       // The word alone, as the start of a line
+        uint32_t wordLast = 0;
+        while (i < length && text[i] != ' ' && text[i] != '\n') {
+            uint32_t c = text[i];
+            extended += step(last, c, characterSize);
+            wordWidth += step(wordLast, c, characterSize);
+            last = wordLast = c;
+            ++i;
+        }
+
+        if (extended > maxWidth && !lineEmpty && i > wordStart && text[wordStart - 1] == ' ') {
+            // The gap's last space becomes the break, so indices stay aligned
+            result.width = max(result.width, lineWidth);
+            text[wordStart - 1] = '\n';
+            result.lineCount++;
+            lineWidth = wordWidth;
+            previous = wordLast;
+        } else {
+            lineWidth = extended;
+            previous = last;
+        }
+        lineEmpty = lineEmpty && i == wordStart;
+    }
+    result.width = max(result.width, lineWidth);
+
+    size_t cost = key.size() + length * sizeof(char32_t) + sizeof(WrappedText);
+    return wrapCache.put(key, std::move(result), cost);
+}
+
+sf::String TextLayout::truncate(const sf::String& text, unsigned characterSize, float maxWidth) {
+    size_t length = text.getSize();
+
+    // prefixWidths[k]: width of the first k characters
+    ArrayList<float> prefixWidths;
+    prefixWidths.reserve(static_cast<int>(length) + 1);
+    prefixWidths.push(0.0f);
+    uint32_t previous = 0;
+    for (size_t i = 0; i < length; ++i) {
+        prefixWidths.push(prefixWidths.getLast() + step(previous, text[i], characterSize));
+        previous = text[i];
+    }
+    if (prefixWidths.getLast() <= maxWidth || length <= 3) {
+        return text;
+    }
+
+    float ellipsisWidth = getAdvance('.', characterSize) * 3 + getKerning('.', '.', characterSize) * 2;
+    auto fits = [&](size_t count) {
+        float kerning = count > 0 ? getKerning(text[count - 1], '.', characterSize) : 0.0f;
+        return prefixWidths[static_cast<int>(count)] + kerning + ellipsisWidth <= maxWidth;
+    };
+
+    // Largest count that fits; widths only grow with count (kerning aside)
+    size_t low = 3;
+    size_t high = length - 1;
+    while (low < high) {
+        size_t middle = low + (high - low + 1) / 2;
+        if (fits(middle)) {
+            low = middle;
+        } else {
+            high = middle - 1;
+        }
+    }
+    return text.substring(0, low) + "...";
+}
+
+void TextLayout::clear() {
+    advances.clear();
+    kernings.clear();
+    wrapCache.clear();
+}
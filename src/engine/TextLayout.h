@@ -0,0 +1,77 @@
+#pragma once
+
+#include "ArrayList.h"
+#include "HashTable.h"
+#include "LruCache.h"
+#include <SFML/Graphics.hpp>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+using namespace std;
+
+// Text wrapped to a width: the input with break spaces turned into '\n', so
+// character i of text is character i of the original
+struct WrappedText {
+    sf::String text;
+    int lineCount = 0;
+    float width = 0.0f;    // Widest line
+};
+
+// Text measurement from cached glyph advances and kerning, laid out the way
+// sf::Text lays out regular-style text (tabs are four spaces). Measuring never
+// builds an sf::Text, wrapping is one pass, and wrap results are memoized per
+// (text, size, width) in an LRU, so re-wrapping the same text on every frame or
+// after a resize costs a hash lookup.
+class TextLayout {
+private:
+    const sf::Font& font;
+
+    // HashTable data structure: Glyph metrics by character size and code point
+    // (see advanceKey and kerningKey), filled on first use
+    HashTable<uint64_t, float> advances;
+    HashTable<uint64_t, float> kernings;
+
+    // LruCache data structure: Wrap results, bounded by approximate bytes
+    LruCache<string, WrappedText> wrapCache;
+
+    static uint64_t advanceKey(uint32_t codePoint, unsigned characterSize) {
+        return (static_cast<uint64_t>(characterSize) << 32) | codePoint;
+    }
+
+    // Code points fit in 21 bits
+    static uint64_t kerningKey(uint32_t first, uint32_t second, unsigned characterSize) {
+        return (static_cast<uint64_t>(characterSize) << 42) | (static_cast<uint64_t>(first) << 21) | second;
+    }
+
+    // Pen movement for c after previous (0 at the start of a line)
+    float step(uint32_t previous, uint32_t c, unsigned characterSize);
+
+public:
+    explicit TextLayout(const sf::Font& font, size_t cacheBudgetBytes = 256 * 1024);
+
+    TextLayout(const TextLayout&) = delete;
+    TextLayout& operator=(const TextLayout&) = delete;
+
+    float getAdvance(uint32_t codePoint, unsigned characterSize);
+    float getKerning(uint32_t first, uint32_t second, unsigned characterSize);
+
+    // Width of text as one line ('\n' is not special)
+    float measure(const sf::String& text, unsigned characterSize);
+
+    // Greedy word wrap at spaces: the space before a word that would cross
+    // maxWidth becomes a line break, '\n' always breaks, and a single word
+    // wider than maxWidth keeps its own line. The reference stays valid until
+    // the next call to wrap.
+    const WrappedText& wrap(string_view utf8, unsigned characterSize, float maxWidth);
+
+    // text unchanged when it fits (or is three characters or fewer), else its
+    // longest prefix of at least three characters that fits with "..."
+    // appended. One measuring pass, then a binary search over the prefix widths.
+    sf::String truncate(const sf::String& text, unsigned characterSize, float maxWidth);
+
+    // Drop cached metrics and layouts (after the font changes)
+    void clear();
+
+    const LruStats& getCacheStats() const { return wrapCache.getStats(); }
+};
@@ -0,0 +1,211 @@
+#include "UIBatch.h"
+#include <algorithm>
+
+namespace {
+// Texel SFML keeps white on every font page (used for underlines)
+const sf::Vector2f WHITE_TEXEL(1.0f, 1.0f);
+
+bool overlaps(const sf::FloatRect& a, const sf::FloatRect& b) {
+    return a.position.x < b.position.x + b.size.x && b.position.x < a.position.x + a.size.x &&
+           a.position.y < b.position.y + b.size.y && b.position.y < a.position.y + a.size.y;
+}
+
+sf::FloatRect merge(const sf::FloatRect& a, const sf::FloatRect& b) {
+    sf::Vector2f topLeft(min(a.position.x, b.position.x), min(a.position.y, b.position.y));
+    sf::Vector2f bottomRight(max(a.position.x + a.size.x, b.position.x + b.size.x),
+                             max(a.position.y + a.size.y, b.position.y + b.size.y));
+    return {topLeft, {bottomRight.x - topLeft.x, bottomRight.y - topLeft.y}};
+}
+
+// Two triangles
+void appendQuad(ArrayList<sf::Vertex>& vertices, sf::Vector2f topLeft, sf::Vector2f bottomRight, sf::Color color,
+                sf::Vector2f texTopLeft, sf::Vector2f texBottomRight) {
+    sf::Vertex topRightVertex{{bottomRight.x, topLeft.y}, color, {texBottomRight.x, texTopLeft.y}};
+    sf::Vertex bottomLeftVertex{{topLeft.x, bottomRight.y}, color, {texTopLeft.x, texBottomRight.y}};
+    vertices.push({topLeft, color, texTopLeft});
+    vertices.push(topRightVertex);
+    vertices.push(bottomLeftVertex);
+    vertices.push(bottomLeftVertex);
+    vertices.push(topRightVertex);
+    vertices.push({bottomRight, color, texBottomRight});
+}
+}
+
+UIBatch::UIBatch() : batchCount(0), drawCalls(0), vertexCount(0) {}
+
+void UIBatch::addSolid(sf::Vector2f topLeft, sf::Vector2f size, sf::Color color) {
+    appendQuad(scratch, topLeft, {topLeft.x + size.x, topLeft.y + size.y}, color, WHITE_TEXEL, WHITE_TEXEL);
+}
+
+// Walk back from the newest batch to the first one that can take the
+// primitive, stopping at any batch it overlaps: the primitive must stay above
+// everything drawn before it
+void UIBatch::commit(const sf::Texture* texture, bool fontPage, const sf::BlendMode& blendMode) {
+    if (scratch.isEmpty()) {
+        return;
+    }
+
+    sf::Vector2f topLeft = scratch[0].position;
+    sf::Vector2f bottomRight = topLeft;
+    for (int i = 1; i < scratch.length(); ++i) {
+        const sf::Vector2f& position = scratch[i].position;
+        topLeft = {min(topLeft.x, position.x), min(topLeft.y, position.y)};
+        bottomRight = {max(bottomRight.x, position.x), max(bottomRight.y, position.y)};
+    }
+    sf::FloatRect scratchBounds(topLeft, {bottomRight.x - topLeft.x, bottomRight.y - topLeft.y});
+
+    Batch* target = nullptr;
+    for (int i = batchCount - 1; i >= 0; --i) {
+        Batch& batch = batches[i];
+        bool compatible = batch.blendMode == blendMode &&
+                          (texture ? batch.texture == texture || (fontPage && !batch.texture)
+                                   : !batch.texture || batch.fontPage);
+        if (compatible) {
+            target = &batch;
+            break;
+        }
+        if (overlaps(batch.bounds, scratchBounds)) {
+            break;
+        }
+    }
+
+    if (!target) {
+        if (batchCount == batches.length()) {
+            batches.emplace();
+        }
+        target = &batches[batchCount++];
+        target->texture = nullptr;
+        target->fontPage = false;
+        target->blendMode = blendMode;
+        target->bounds = scratchBounds;
+    } else {
+        target->bounds = merge(target->bounds, scratchBounds);
+    }
+    if (texture && !target->texture) {
+        // Solid quads already in the batch sample the page's white texel
+        target->texture = texture;
+        target->fontPage = fontPage;
+    }
+
+    for (int i = 0; i < scratch.length(); ++i) {
+        target->vertices.push(scratch[i]);
+    }
+    scratch.clear();
+}
+
+void UIBatch::addRect(sf::Vector2f position, sf::Vector2f size, sf::Color fill,
+                      float outlineThickness, sf::Color outline) {
+    if (fill.a > 0) {
+        addSolid(position, size, fill);
+    }
+    if (outlineThickness > 0 && outline.a > 0) {
+        float t = outlineThickness;
+        addSolid({position.x - t, position.y - t}, {size.x + 2 * t, t}, outline);
+        addSolid({position.x - t, position.y + size.y}, {size.x + 2 * t, t}, outline);
+        addSolid({position.x - t, position.y}, {t, size.y}, outline);
+        addSolid({position.x + size.x, position.y}, {t, size.y}, outline);
+    }
+    commit(nullptr, false, sf::BlendAlpha);
+}
+
+void UIBatch::addRect(const sf::RectangleShape& rect) {
+    addRect(rect.getPosition(), rect.getSize(), rect.getFillColor(), rect.getOutlineThickness(), rect.getOutlineColor());
+}
+
+void UIBatch::addText(const sf::Font& font, const sf::String& text, unsigned characterSize, sf::Vector2f position,
+                      sf::Color color, bool bold) {
+    layoutText(font, text, characterSize, position, color, bold, scratch);
+
+    // Glyphs are only rendered into the page texture by getGlyph, so it is
+    // fetched afterwards
+    commit(&font.getTexture(characterSize), true, sf::BlendAlpha);
+}
+
+void UIBatch::addText(const sf::Text& text) {
+    addText(text.getFont(), text.getString(), text.getCharacterSize(), text.getPosition(), text.getFillColor(),
+            (text.getStyle() & sf::Text::Bold) != 0);
+}
+
+// Same pen rules and glyph quads (one texel of padding) as sf::Text
+void UIBatch::layoutText(const sf::Font& font, const sf::String& text, unsigned characterSize, sf::Vector2f position,
+                         sf::Color color, bool bold, ArrayList<sf::Vertex>& vertices, ArrayList<int>* characterEnds) {
+    float whitespaceWidth = font.getGlyph(U' ', characterSize, bold).advance;
+    float lineSpacing = font.getLineSpacing(characterSize);
+    float x = 0.0f;
+    float y = static_cast<float>(characterSize);
+    uint32_t previous = 0;
+
+    for (size_t i = 0; i < text.getSize(); ++i) {
+        uint32_t c = text[i];
+        if (characterEnds && i > 0) {
+            characterEnds->push(vertices.length());
+        }
+        if (c == U'\r') {
+            continue;
+        }
+        x += font.getKerning(previous, c, characterSize, bold);
+        previous = c;
+
+        if (c == U' ') {
+            x += whitespaceWidth;
+            continue;
+        }
+        if (c == U'\t') {
+            x += whitespaceWidth * 4;
+            continue;
+        }
+        if (c == U'\n') {
+            y += lineSpacing;
+            x = 0.0f;
+            continue;
+        }
+
+        const sf::Glyph& glyph = font.getGlyph(c, characterSize, bold);
+        const float padding = 1.0f;
+        sf::Vector2f topLeft(position.x + x + glyph.bounds.position.x - padding,
+                             position.y + y + glyph.bounds.position.y - padding);
+        sf::Vector2f bottomRight(topLeft.x + glyph.bounds.size.x + 2 * padding,
+                                 topLeft.y + glyph.bounds.size.y + 2 * padding);
+        sf::Vector2f texTopLeft(static_cast<float>(glyph.textureRect.position.x) - padding,
+                                static_cast<float>(glyph.textureRect.position.y) - padding);
+        sf::Vector2f texBottomRight(texTopLeft.x + static_cast<float>(glyph.textureRect.size.x) + 2 * padding,
+                                    texTopLeft.y + static_cast<float>(glyph.textureRect.size.y) + 2 * padding);
+        appendQuad(vertices, topLeft, bottomRight, color, texTopLeft, texBottomRight);
+        x += glyph.advance;
+    }
+    if (characterEnds && text.getSize() > 0) {
+        characterEnds->push(vertices.length());
+    }
+}
+
+void UIBatch::addGlyphs(const sf::Font& font, unsigned characterSize, const ArrayList<sf::Vertex>& vertices, int count,
+                        sf::Vector2f offset) {
+    for (int i = 0; i < count; ++i) {
+        sf::Vertex vertex = vertices[i];
+        vertex.position = {vertex.position.x + offset.x, vertex.position.y + offset.y};
+        scratch.push(vertex);
+    }
+    commit(&font.getTexture(characterSize), true, sf::BlendAlpha);
+}
+
+void UIBatch::addTexture(const sf::Texture& texture, sf::Vector2f position, const sf::BlendMode& blendMode) {
+    sf::Vector2f size(static_cast<float>(texture.getSize().x), static_cast<float>(texture.getSize().y));
+    appendQuad(scratch, position, {position.x + size.x, position.y + size.y}, sf::Color::White, {0.0f, 0.0f}, size);
+    commit(&texture, false, blendMode);
+}
+
+void UIBatch::flush(sf::RenderTarget& target) {
+    drawCalls = 0;
+    vertexCount = 0;
+    for (int i = 0; i < batchCount; ++i) {
+        Batch& batch = batches[i];
+        sf::RenderStates states(batch.blendMode);
+        states.texture = batch.texture;
+        target.draw(batch.vertices.getData(), static_cast<size_t>(batch.vertices.length()),
+                    sf::PrimitiveType::Triangles, states);
+        ++drawCalls;
+        vertexCount += batch.vertices.length();
+        batch.vertices.clear();
+    }
+    batchCount = 0;
+}
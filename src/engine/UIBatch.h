@@ -0,0 +1,82 @@
+#pragma once
+
+#include "ArrayList.h"
+#include <SFML/Graphics.hpp>
+
+using namespace std;
+
+// Batched 2D renderer for the UI: rectangles, text and textures become quads
+// in one vertex array per (texture, blend mode), drawn at flush with one draw
+// call per array.
+//
+// Solid quads sample the white texel SFML reserves at (1, 1) of every font
+// page, so they share a batch with text of any size. A primitive joins the
+// most recent compatible batch it can move back to without passing a batch it
+// overlaps, so drawing order is preserved wherever it is visible. Vertex
+// storage is kept between frames: steady-state frames do not allocate.
+class UIBatch {
+private:
+    struct Batch {
+        const sf::Texture* texture = nullptr;   // Null while the batch holds only solid quads
+        bool fontPage = false;                  // texture has the white texel
+        sf::BlendMode blendMode;
+        ArrayList<sf::Vertex> vertices;         // Triangles
+        sf::FloatRect bounds;
+    };
+
+    // ArrayList data structure: Batches in drawing order; the first batchCount
+    // are in use, the rest keep their vertex storage for later frames
+    ArrayList<Batch> batches;
+    int batchCount;
+    ArrayList<sf::Vertex> scratch;   // The primitive being added
+    int drawCalls;
+    int vertexCount;
+
+    void addSolid(sf::Vector2f topLeft, sf::Vector2f size, sf::Color color);
+
+    // Move scratch into a batch; texture null for solid quads
+    void commit(const sf::Texture* texture, bool fontPage, const sf::BlendMode& blendMode);
+
+public:
+    UIBatch();
+
+    UIBatch(const UIBatch&) = delete;
+    UIBatch& operator=(const UIBatch&) = delete;
+
+    // Like sf::RectangleShape: the outline is drawn outside the rectangle
+    void addRect(sf::Vector2f position, sf::Vector2f size, sf::Color fill,
+                 float outlineThickness = 0.0f, sf::Color outline = sf::Color::Transparent);
+
+    // An sf::RectangleShape's position, size, fill and outline
+    void addRect(const sf::RectangleShape& rect);
+
+    // Glyph quads placed the way sf::Text places them ('\n' starts a line,
+    // tabs are four spaces)
+    void addText(const sf::Font& font, const sf::String& text, unsigned characterSize, sf::Vector2f position,
+                 sf::Color color, bool bold = false);
+
+    // An sf::Text's string, font, size, fill color, bold style and position
+    // (origin, rotation and scale are not applied)
+    void addText(const sf::Text& text);
+
+    // Glyph quads of text as addText places them, appended to vertices. With
+    // characterEnds, entry i is the vertex count once characters 0..i are
+    // laid out, so any prefix of the text is a prefix of the vertices.
+    static void layoutText(const sf::Font& font, const sf::String& text, unsigned characterSize,
+                           sf::Vector2f position, sf::Color color, bool bold, ArrayList<sf::Vertex>& vertices,
+                           ArrayList<int>* characterEnds = nullptr);
+
+    // The first count of vertices laid out by layoutText, moved by offset
+    void addGlyphs(const sf::Font& font, unsigned characterSize, const ArrayList<sf::Vertex>& vertices, int count,
+                   sf::Vector2f offset = {0.0f, 0.0f});
+
+    // A whole texture at position, e.g. a retained panel
+    void addTexture(const sf::Texture& texture, sf::Vector2f position, const sf::BlendMode& blendMode = sf::BlendAlpha);
+
+    // Draw everything added since the last flush and start a new frame
+    void flush(sf::RenderTarget& target);
+
+    // Draw calls and vertices of the last flush
+    [[nodiscard]] int getDrawCalls() const { return drawCalls; }
+    [[nodiscard]] int getVertexCount() const { return vertexCount; }
+};
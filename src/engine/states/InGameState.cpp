@@ -1,5 +1,6 @@
 #include <iostream>
 #include <algorithm>
+#include <cstdlib>
 #include "InGameState.h"
 #include "MainMenuState.h"
 #include "LoadGameState.h"
@@ -18,8 +19,11 @@ InGameState::InGameState(GameEngine& game)
       dialogueUI(game.getWindow()),
       currentDialogueNode(nullptr),
       currentNodeId("root"),
+      seenReloadCount(game.getDialogueGraph() ? game.getDialogueGraph()->getReloadCount() : 0),
       showMenu(false),
-      hoveredButton(-1) {
+      hoveredButton(-1),
+      reportDrawCalls(getenv("UI_DRAW_STATS") != nullptr),
+      drawCallsReported(-1) {
     cout << "InGameState constructor start" << endl;
 
     if (!font.openFromFile("assets/arial.ttf")) {
@@ -86,33 +90,24 @@ InGameState::InGameState(GameEngine& game)
 
     auto* dialogueGraph = game.getDialogueGraph();
     if (dialogueGraph) {
-        dialogueGraph->setDialogueStartCallback([this](NTree<Dialogue, MAX_CHOICES>* node, const string& nodeId) {
-            if (node && !node->isEmpty()) {
+        dialogueGraph->setDialogueStartCallback([this](Dialogue* node, string_view nodeId) {
+            if (node) {
                 // Save current node to history before navigating
                 if (!currentNodeId.empty()) {
                     dialogueHistory.push(currentNodeId);
                 }
-
-                // Update current node and its ID
-                currentNodeId = nodeId;
-                currentDialogueNode = node;
-                // Visitor pattern: Apply multiple visitors to dialogue
-                dialogueUI.displayDialogue(currentDialogueNode->getKey());
+                enterNode(node, nodeId);
             } else {
                 currentDialogueNode = nullptr;
             }
         });
+        dialogueGraph->setTimelineCallback([this](string_view name) { startTimeline(name); });
 
         auto* rootNode = dialogueGraph->buildTree();
         if (rootNode) {
             game.getPlayer().displayStatus();
-            if (rootNode && !rootNode->isEmpty()) {
-                currentDialogueNode = rootNode;
-                // Visitor pattern: Apply multiple visitors to dialogue
-                dialogueUI.displayDialogue(currentDialogueNode->getKey());
-            } else {
-                currentDialogueNode = nullptr;
-            }
+            // The root's real ID, not "root", so reloads can look it up
+            enterNode(rootNode, dialogueGraph->getNodeId(dialogueGraph->getRootNode()));
         }
     }
     cout << "InGameState constructor end" << endl;
@@ -123,8 +118,11 @@ InGameState::InGameState(GameEngine& game, const string& startNodeId)
       dialogueUI(game.getWindow()),
       currentDialogueNode(nullptr),
       currentNodeId(startNodeId),
+      seenReloadCount(game.getDialogueGraph() ? game.getDialogueGraph()->getReloadCount() : 0),
       showMenu(false),
-      hoveredButton(-1) {
+      hoveredButton(-1),
+      reportDrawCalls(getenv("UI_DRAW_STATS") != nullptr),
+      drawCallsReported(-1) {
 
     if (!font.openFromFile("assets/arial.ttf")) {
         cerr << "Error loading UI font" << endl;
@@ -186,34 +184,26 @@ InGameState::InGameState(GameEngine& game, const string& startNodeId)
 
     auto* dialogueGraph = game.getDialogueGraph();
     if (dialogueGraph) {
-        dialogueGraph->setDialogueStartCallback([this](NTree<Dialogue, MAX_CHOICES>* node, const string& nodeId) {
-            if (node && !node->isEmpty()) {
+        dialogueGraph->setDialogueStartCallback([this](Dialogue* node, string_view nodeId) {
+            if (node) {
                 // Save current node to history before navigating
                 if (!currentNodeId.empty()) {
                     dialogueHistory.push(currentNodeId);
                 }
-
-                // Update current node and its ID
-                currentNodeId = nodeId;
-                currentDialogueNode = node;
-                // Visitor pattern: Apply multiple visitors to dialogue
-                dialogueUI.displayDialogue(currentDialogueNode->getKey());
+                enterNode(node, nodeId);
             }
         });
+        dialogueGraph->setTimelineCallback([this](string_view name) { startTimeline(name); });
 
         auto* rootNode = dialogueGraph->buildTree();
         if (rootNode) {
             game.getPlayer().displayStatus();
             if (startNodeId == "root") {
-                currentDialogueNode = rootNode;
-                // Visitor pattern: Apply multiple visitors to dialogue
-                dialogueUI.displayDialogue(currentDialogueNode->getKey());
+                enterNode(rootNode, dialogueGraph->getNodeId(dialogueGraph->getRootNode()));
             } else {
                 auto* loadNode = dialogueGraph->getNode(startNodeId);
-                if (loadNode && !loadNode->isEmpty()) {
-                    currentDialogueNode = loadNode;
-                    // Visitor pattern: Apply multiple visitors to dialogue
-                    dialogueUI.displayDialogue(currentDialogueNode->getKey());
+                if (loadNode) {
+                    enterNode(loadNode, startNodeId);
                 }
             }
         }
@@ -234,6 +224,7 @@ void InGameState::handleInput() {
         }
 
         if (const auto* keyPressed = event->getIf<sf::Event::KeyPressed>()) {
+            timelines.notifyInput(); // Resume timelines waiting for the player
             if (keyPressed->code == sf::Keyboard::Key::F5) {
                 saveGame();
             }
@@ -244,6 +235,7 @@ void InGameState::handleInput() {
 
         if (const auto* mouseButtonPressed = event->getIf<sf::Event::MouseButtonPressed>()) {
             if (mouseButtonPressed->button == sf::Mouse::Button::Left) {
+                timelines.notifyInput();
                 sf::Vector2i mousePos = sf::Mouse::getPosition(game.getWindow());
 
                 if (isMouseOverButton(backButton, mousePos)) {
@@ -285,15 +277,58 @@ void InGameState::update(float dt) {
     auto* dialogueGraph = game.getDialogueGraph();
     if (dialogueGraph) {
         dialogueGraph->update(dt);
+        if (dialogueGraph->getReloadCount() != seenReloadCount) {
+            refreshAfterReload();
+        }
+    }
+    timelines.update(dt);
+}
+
+// A script was hot-reloaded: show the new version of the current node,
+// without touching the undo history, the conversation log or timelines
+// (the player is still on the node, not entering it again)
+void InGameState::refreshAfterReload() {
+    auto* dialogueGraph = game.getDialogueGraph();
+    seenReloadCount = dialogueGraph->getReloadCount();
+    if (!currentDialogueNode) {
+        return;
+    }
+
+    auto* node = dialogueGraph->getNode(currentNodeId);
+    if (node) {
+        currentDialogueNode = node;
+        dialogueUI.refreshDialogue(*currentDialogueNode);
+    }
+}
+
+// Every node the player enters becomes current here, so timelines waiting on it wake
+void InGameState::enterNode(Dialogue* node, string_view nodeId) {
+    currentNodeId = nodeId;
+    currentDialogueNode = node;
+    // Visitor pattern: Apply multiple visitors to dialogue
+    dialogueUI.displayDialogue(*currentDialogueNode);
+    timelines.notifyNodeEntered(currentNodeId);
+}
+
+void InGameState::startTimeline(string_view name) {
+    if (!TimelineRegistry::global().start(name, timelines, game.getPlayer())) {
+        cerr << "Unknown timeline: " << name << endl;
     }
 }
 
 void InGameState::render(sf::RenderWindow& window) {
     if (currentDialogueNode && dialogueUI.isDialogueActive()) {
-        dialogueUI.render();
+        dialogueUI.render(uiBatch);
     }
 
     drawUIButtons();
+    uiBatch.flush(window);
+
+    // Draw calls per frame, printed when the count changes
+    if (reportDrawCalls && uiBatch.getDrawCalls() != drawCallsReported) {
+        drawCallsReported = uiBatch.getDrawCalls();
+        cout << "UI draw calls: " << drawCallsReported << " (" << uiBatch.getVertexCount() << " vertices)" << endl;
+    }
 }
 
 void InGameState::saveGame() {
@@ -328,8 +363,8 @@ void InGameState::drawUIButtons() {
             buttons[i]->setOutlineThickness(2);
         }
 
-        game.getWindow().draw(*buttons[i]);
-        game.getWindow().draw(*buttonTexts[i]);
+        uiBatch.addRect(*buttons[i]);
+        uiBatch.addText(*buttonTexts[i]);
     }
 }
 
@@ -348,10 +383,8 @@ void InGameState::navigateToNode(const string& nodeId) {
     auto* dialogueGraph = game.getDialogueGraph();
     if (dialogueGraph) {
         auto* node = dialogueGraph->getNode(nodeId);
-        if (node && !node->isEmpty()) {
-            currentDialogueNode = node;
-            // Visitor pattern: Apply multiple visitors to dialogue
-            dialogueUI.displayDialogue(currentDialogueNode->getKey());
+        if (node) {
+            enterNode(node, nodeId);
         }
     }
 }
@@ -364,10 +397,8 @@ void InGameState::undoLastChoice() {
         auto* dialogueGraph = game.getDialogueGraph();
         if (dialogueGraph) {
             auto* node = dialogueGraph->getNode(previousNodeId);
-            if (node && !node->isEmpty()) {
-                currentDialogueNode = node;
-                // Visitor pattern: Apply multiple visitors to dialogue
-                dialogueUI.displayDialogue(currentDialogueNode->getKey());
+            if (node) {
+                enterNode(node, previousNodeId);
             }
         }
     }
@@ -2,12 +2,14 @@
 
 #include "GameState.h"
 #include "engine/DialogueUI.h"
+#include "engine/UIBatch.h"
 #include "dialogue/Dialogue.h"
 #include "dialogue/DialogueGraph.h"
-#include "NTree.h"
+#include "dialogue/Timeline.h"
 #include "Stack.h"
 #include <SFML/Graphics.hpp>
 #include <string>
+#include <string_view>
 
 using namespace std;
 
@@ -16,13 +18,18 @@ private:
     // Coordinates multiple visitors for dialogue operations
     DialogueUI dialogueUI;
 
-    // NTree data structure: Current node in dialogue tree
-    NTree<Dialogue, MAX_CHOICES>* currentDialogueNode;
+    // Current node's view, owned by the compiled dialogue graph
+    Dialogue* currentDialogueNode;
     string currentNodeId;
+    int seenReloadCount;   // Graph reloads already reflected in currentDialogueNode
 
     // Stack data structure: Dialogue history for undo functionality (LIFO)
     Stack<string> dialogueHistory;
 
+    // Scripted timelines; declared after the UI and history they may touch,
+    // so their frames are destroyed first
+    TimelineScheduler timelines;
+
     // SFML: UI components
     sf::Font font;
     sf::RectangleShape saveButton;
@@ -37,6 +44,11 @@ private:
     bool showMenu;
     int hoveredButton;
 
+    // Batched UI drawing: everything on screen is added, then flushed once
+    UIBatch uiBatch;
+    bool reportDrawCalls;      // UI_DRAW_STATS is set
+    int drawCallsReported;
+
 public:
     explicit InGameState(GameEngine& game);
     explicit InGameState(GameEngine& game, const string& startNodeId);
@@ -48,13 +60,21 @@ public:
 
     void saveGame();
     string getCurrentNodeId() const { return currentNodeId; }
+    TimelineScheduler& getTimelines() { return timelines; }
 
 private:
     // UI rendering and interaction
     void drawUIButtons();
     bool isMouseOverButton(const sf::RectangleShape& button, const sf::Vector2i& mousePos);
 
+    // Make node current and show it; every navigation path ends here
+    void enterNode(Dialogue* node, string_view nodeId);
+
+    // Start a named timeline (a choice's "timeline:<name>" effect)
+    void startTimeline(string_view name);
+
     // Navigation with undo support using stack
     void navigateToNode(const string& nodeId);
     void undoLastChoice();
+    void refreshAfterReload();
 };
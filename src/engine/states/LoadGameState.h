@@ -2,7 +2,7 @@
 
 #include "GameState.h"
 #include "game/SaveSystem.h"
-#include "List.h"
+#include "ArrayList.h"
 #include <SFML/Graphics.hpp>
 
 using namespace std;
@@ -11,8 +11,8 @@ class LoadGameState : public GameState {
 private:
     sf::Font font;
     sf::Text* title;
-    List<sf::Text*> slotTexts;
-    List<sf::RectangleShape*> slotBoxes;
+    ArrayList<sf::Text*> slotTexts;
+    ArrayList<sf::RectangleShape*> slotBoxes;
 
     int selectedSlot;
     bool fromMainMenu;
@@ -6,7 +6,7 @@
 #include "SettingsState.h"
 #include "game/SaveSystem.h"
 #include <SFML/Window/Event.hpp>
-#include "List.h"
+#include "ArrayList.h"
 #include "AssetPaths.h"
 
 using namespace std;
@@ -26,8 +26,8 @@ MainMenuState::MainMenuState(GameEngine& game) : GameState(game), title(nullptr)
     title->setFillColor(sf::Color::White);
     title->setPosition({300, 100});
 
-    // List data structure: Create menu options
-    List<string> items = {"New Game", "Load Game", "Settings", "Exit"};
+    // ArrayList data structure: Create menu options
+    ArrayList<string> items = {"New Game", "Load Game", "Settings", "Exit"};
     for (int i = 0; i < items.length(); ++i) {
         sf::Text* text = new sf::Text(font, items[i], 30);
         text->setFillColor(sf::Color::White);
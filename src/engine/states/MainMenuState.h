@@ -2,7 +2,7 @@
 
 #include "GameState.h"
 #include <SFML/Graphics.hpp>
-#include "List.h"
+#include "ArrayList.h"
 #include "AssetPaths.h"
 
 using namespace std;
@@ -13,8 +13,8 @@ private:
     sf::Font font;
     sf::Text* title;
 
-    // List data structure: Menu options (New Game, Load, Settings, Exit)
-    List<sf::Text*> menuItems;
+    // ArrayList data structure: Menu options (New Game, Load, Settings, Exit)
+    ArrayList<sf::Text*> menuItems;
     int selectedItemIndex;
 
 public:
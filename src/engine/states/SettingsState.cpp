@@ -16,7 +16,7 @@ SettingsState::SettingsState(GameEngine& game) : GameState(game), title(nullptr)
     title->setPosition({400, 50});
 
     // Create option labels
-    List<string> labels = {
+    ArrayList<string> labels = {
         "Window Size:",
         "Text Speed:",
         "Master Volume:",
@@ -2,7 +2,7 @@
 
 #include "GameState.h"
 #include <SFML/Graphics.hpp>
-#include "List.h"
+#include "ArrayList.h"
 
 using namespace std;
 
@@ -18,8 +18,8 @@ class SettingsState : public GameState {
 private:
     sf::Font font;
     sf::Text* title;
-    List<sf::Text*> optionLabels;
-    List<sf::Text*> optionValues;
+    ArrayList<sf::Text*> optionLabels;
+    ArrayList<sf::Text*> optionValues;
     int selectedOptionIndex;
 
 public:
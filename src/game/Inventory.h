@@ -2,6 +2,7 @@
 #include "List.h"
 #include "Item.h"
 #include <iostream>
+#include <string_view>
 
 using namespace std;
 
@@ -11,18 +12,23 @@ private:
     int maxWeight;
     int currentWeight;
     int gold;
+    unsigned revision;   // Bumped by every change, so views can tell when to redraw
 
 public:
     Inventory(int maxCapacity = 100)
-        : maxWeight(maxCapacity), currentWeight(0), gold(0) {}
+        : maxWeight(maxCapacity), currentWeight(0), gold(0), revision(0) {}
 
     // Gold management
     int getGold() const { return gold; }
-    void setGold(int amount) { gold = amount; }
+    void setGold(int amount) {
+        gold = amount;
+        revision++;
+    }
 
     // Add gold to inventory
     void addGold(int amount) {
         gold += amount;
+        revision++;
         cout << "Gained " << amount << " gold! (Total: " << gold << ")" << endl;
     }
 
@@ -30,6 +36,7 @@ public:
     bool spendGold(int amount) {
         if (gold >= amount) {
             gold -= amount;
+            revision++;
             cout << "Spent " << amount << " gold. (Remaining: " << gold << ")" << endl;
             return true;
         }
@@ -39,13 +46,14 @@ public:
 
     // List data structure: Add item to inventory
     bool addItem(const Item& item) {
-        if (currentWeight + item.weight > maxWeight) {
-            cout << "Inventory full! Cannot carry " << item.name << endl;
+        if (currentWeight + item.getWeight() > maxWeight) {
+            cout << "Inventory full! Cannot carry " << item.getName() << endl;
             return false;
         }
         items.push(item);
-        currentWeight += item.weight;
-        cout << "Added " << item.name << " to inventory." << endl;
+        currentWeight += item.getWeight();
+        revision++;
+        cout << "Added " << item.getName() << " to inventory." << endl;
         return true;
     }
 
@@ -56,10 +64,11 @@ public:
         int index = 0;
 
         while (it != endIt) {
-            if (it.getCurrent()->getValue().name == itemName) {
+            if (it.getCurrent()->getValue().getName() == itemName) {
                 Item removedItem = items[index];
                 items.removeAt(index);
-                currentWeight -= removedItem.weight;
+                currentWeight -= removedItem.getWeight();
+                revision++;
                 cout << "Removed " << itemName << " from inventory." << endl;
                 return true;
             }
@@ -71,12 +80,12 @@ public:
     }
 
     // List data structure: Find item by name (linear search)
-    Item* findItem(const string& itemName) {
+    Item* findItem(string_view itemName) {
         auto it = items.getIterator();
         auto endIt = it.end();
 
         while (it != endIt) {
-            if (it.getCurrent()->getValue().name == itemName) {
+            if (it.getCurrent()->getValue().getName() == itemName) {
                 return &(it.getCurrent()->getValue());
             }
             ++it;
@@ -85,7 +94,7 @@ public:
     }
 
     // Check if item exists in inventory
-    bool hasItem(const string& itemName) const {
+    bool hasItem(string_view itemName) const {
         return const_cast<Inventory*>(this)->findItem(itemName) != nullptr;
     }
 
@@ -102,6 +111,11 @@ public:
         return maxWeight;
     }
 
+    // Changes whenever gold or the item list changes
+    unsigned getRevision() const {
+        return revision;
+    }
+
     // List data structure: Get iterator for traversal
     auto getIterator() {
         return items.getIterator();
@@ -125,15 +139,16 @@ public:
 
         while (it != endIt) {
             const Item& item = it.getCurrent()->getValue();
-            cout << index << ". " << item.name
-                     << " (Value: " << item.value
-                     << ", Weight: " << item.weight << ")" << endl;
+            cout << index << ". " << item.getName()
+                     << " (Value: " << item.getValue()
+                     << ", Weight: " << item.getWeight() << ")" << endl;
             ++it;
             ++index;
         }
     }
 
-    // List data structure: Get reference to items list
+    // List data structure: Get reference to items list (read only: changes
+    // made through it do not bump the revision)
     List<Item>& getItems() {
         return items;
     }
@@ -142,5 +157,6 @@ public:
     void clear() {
         items.clear();
         currentWeight = 0;
+        revision++;
     }
 };
@@ -1,5 +1,10 @@
 #pragma once
+#include "HashTable.h"
+#include "List.h"
+#include <charconv>
+#include <stdexcept>
 #include <string>
+#include <string_view>
 
 using namespace std;
 
@@ -12,46 +17,188 @@ enum class ItemType {
     MISC
 };
 
-class Item {
-public:
+// Immutable data shared by every copy of an item (flyweight). Prototypes are
+// created through ItemRegistry and live for the whole run.
+struct ItemPrototype {
     string name;
     string description;
-    ItemType type;
-    int value;  // Gold value
-    int weight;  // Inventory weight
+    ItemType type = ItemType::MISC;
+    int weight = 0;  // Inventory weight
 
     // Consumable properties
-    int healthRestore;
-    int manaRestore;
+    int healthRestore = 0;
+    int manaRestore = 0;
 
     // Equipment properties
-    int attackBonus;
-    int defenseBonus;
+    int attackBonus = 0;
+    int defenseBonus = 0;
+
+    bool operator==(const ItemPrototype& other) const = default;
+
+    // The prototype of default-constructed items
+    static const ItemPrototype NONE;
+};
+
+inline const ItemPrototype ItemPrototype::NONE{};
+
+// HashTable data structure: Interned item prototypes. Equal definitions share
+// one prototype, and item specs from scripts ("name:type:bonus") are parsed
+// once. Not thread-safe: script workers parse specs with parseSpec and the
+// results are interned when the scripts merge on the main thread.
+class ItemRegistry {
+private:
+    List<ItemPrototype> prototypes;                          // Stable addresses
+    HashTable<string, const ItemPrototype*> byDefinition;    // Key: every field, see definitionKey
+    HashTable<string, const ItemPrototype*> bySpec;
+
+    static string definitionKey(const ItemPrototype& definition) {
+        string key = definition.name;
+        key += '\x1f';
+        key += definition.description;
+        for (int field : {static_cast<int>(definition.type), definition.weight, definition.healthRestore,
+                          definition.manaRestore, definition.attackBonus, definition.defenseBonus}) {
+            key += '\x1f';
+            key += to_string(field);
+        }
+        return key;
+    }
+
+    static string_view trim(string_view text) {
+        size_t first = text.find_first_not_of(" \t\r\n");
+        if (first == string_view::npos) {
+            return {};
+        }
+        size_t last = text.find_last_not_of(" \t\r\n");
+        return text.substr(first, last - first + 1);
+    }
+
+public:
+    ItemRegistry() = default;
+    ItemRegistry(const ItemRegistry&) = delete;
+    ItemRegistry& operator=(const ItemRegistry&) = delete;
+
+    // The registry every Item and DialogueGraph shares
+    static ItemRegistry& global() {
+        static ItemRegistry registry;
+        return registry;
+    }
+
+    // The shared prototype equal to definition, created on first use
+    const ItemPrototype* intern(const ItemPrototype& definition) {
+        string key = definitionKey(definition);
+        if (const ItemPrototype** existing = byDefinition.search(key)) {
+            return *existing;
+        }
+        const ItemPrototype* prototype = &prototypes.emplace(definition);
+        byDefinition.insert(std::move(key), prototype);
+        return prototype;
+    }
+
+    // Prototype for a script item spec; throws like parseSpec on a bad bonus
+    const ItemPrototype* fromSpec(string_view spec) {
+        if (const ItemPrototype** existing = bySpec.search(spec)) {
+            return *existing;
+        }
+        const ItemPrototype* prototype = intern(parseSpec(spec));
+        bySpec.insert(string(spec), prototype);
+        return prototype;
+    }
+
+    [[nodiscard]] int size() const { return prototypes.length(); }
+
+    // "name:type:bonus", type and bonus optional. The bonus goes to the
+    // type's stat (attack, defense or health restored) and is read like stoi:
+    // trailing text ignored, invalid_argument / out_of_range on failure.
+    static ItemPrototype parseSpec(string_view spec) {
+        ItemPrototype definition;
+        definition.name = "Unknown";
+        definition.weight = 1;
+        int bonus = 0;
+
+        int index = 0;
+        size_t start = 0;
+        while (start < spec.size() && index < 3) {
+            size_t end = spec.find(':', start);
+            if (end == string_view::npos) {
+                end = spec.size();
+            }
+            string_view part = trim(spec.substr(start, end - start));
+            if (index == 0) {
+                definition.name = string(part);
+            } else if (index == 1) {
+                definition.type = parseType(part);
+            } else {
+                if (!part.empty() && part[0] == '+') {
+                    part.remove_prefix(1);
+                }
+                auto [rest, error] = from_chars(part.data(), part.data() + part.size(), bonus);
+                if (error == errc::invalid_argument) {
+                    throw invalid_argument("item bonus is not a number: '" + string(part) + "'");
+                }
+                if (error == errc::result_out_of_range) {
+                    throw out_of_range("item bonus does not fit in int: '" + string(part) + "'");
+                }
+            }
+            start = end + 1;
+            ++index;
+        }
+
+        if (definition.type == ItemType::WEAPON) {
+            definition.attackBonus = bonus;
+        } else if (definition.type == ItemType::ARMOR) {
+            definition.defenseBonus = bonus;
+        } else if (definition.type == ItemType::POTION || definition.type == ItemType::CONSUMABLE) {
+            definition.healthRestore = bonus;
+        }
+        return definition;
+    }
+
+    static ItemType parseType(string_view typeName) {
+        if (typeName == "WEAPON") return ItemType::WEAPON;
+        if (typeName == "ARMOR") return ItemType::ARMOR;
+        if (typeName == "POTION") return ItemType::POTION;
+        if (typeName == "QUEST_ITEM") return ItemType::QUEST_ITEM;
+        if (typeName == "CONSUMABLE") return ItemType::CONSUMABLE;
+        return ItemType::MISC;
+    }
+};
+
+// One item the player holds: a pointer to its shared prototype plus the
+// per-copy gold value, so copies are cheap and carry no strings
+class Item {
+private:
+    const ItemPrototype* prototype;
+    int value;  // Gold value
+
+public:
+    Item() : prototype(&ItemPrototype::NONE), value(0) {}
 
-    // Default constructor
-    Item()
-        : name(""), description(""), type(ItemType::MISC),
-          value(0), weight(0), healthRestore(0), manaRestore(0),
-          attackBonus(0), defenseBonus(0) {}
+    explicit Item(const ItemPrototype* itemPrototype, int itemValue = 0)
+        : prototype(itemPrototype), value(itemValue) {}
 
-    // Parameterized constructor
-    Item(const string& itemName, ItemType itemType, int itemValue = 0)
-        : name(itemName), description(""), type(itemType),
-          value(itemValue), weight(1), healthRestore(0), manaRestore(0),
-          attackBonus(0), defenseBonus(0) {}
+    const ItemPrototype& getPrototype() const { return *prototype; }
+    const string& getName() const { return prototype->name; }
+    const string& getDescription() const { return prototype->description; }
+    ItemType getType() const { return prototype->type; }
+    int getValue() const { return value; }
+    int getWeight() const { return prototype->weight; }
+    int getHealthRestore() const { return prototype->healthRestore; }
+    int getManaRestore() const { return prototype->manaRestore; }
+    int getAttackBonus() const { return prototype->attackBonus; }
+    int getDefenseBonus() const { return prototype->defenseBonus; }
 
     // Equality operator for item comparison
     bool operator==(const Item& other) const {
-        return name == other.name;
+        return prototype == other.prototype || prototype->name == other.prototype->name;
     }
 
     // Check if item can be consumed
     bool isConsumable() const {
-        return type == ItemType::POTION || type == ItemType::CONSUMABLE;
+        return prototype->type == ItemType::POTION || prototype->type == ItemType::CONSUMABLE;
     }
 
     // Check if item can be equipped
     bool isEquippable() const {
-        return type == ItemType::WEAPON || type == ItemType::ARMOR;
+        return prototype->type == ItemType::WEAPON || prototype->type == ItemType::ARMOR;
     }
 };
@@ -41,11 +41,11 @@ public:
 
         if (item->isConsumable()) {
             // Apply consumable effects
-            if (item->healthRestore > 0) {
-                stats.heal(item->healthRestore);
+            if (item->getHealthRestore() > 0) {
+                stats.heal(item->getHealthRestore());
             }
-            if (item->manaRestore > 0) {
-                stats.restoreMana(item->manaRestore);
+            if (item->getManaRestore() > 0) {
+                stats.restoreMana(item->getManaRestore());
             }
 
             // Remove consumable from inventory
@@ -69,42 +69,42 @@ public:
             return;
         }
 
-        if (item->type == ItemType::WEAPON) {
+        if (item->getType() == ItemType::WEAPON) {
             if (equippedWeapon) {
                 // Unequip current weapon
-                stats.modifyStrength(-equippedWeapon->attackBonus);
-                cout << "Unequipped " << equippedWeapon->name << endl;
+                stats.modifyStrength(-equippedWeapon->getAttackBonus());
+                cout << "Unequipped " << equippedWeapon->getName() << endl;
             }
 
             equippedWeapon = item;
-            stats.modifyStrength(item->attackBonus);
-            cout << "Equipped " << item->name << " (+" << item->attackBonus << " STR)" << endl;
+            stats.modifyStrength(item->getAttackBonus());
+            cout << "Equipped " << item->getName() << " (+" << item->getAttackBonus() << " STR)" << endl;
         }
-        else if (item->type == ItemType::ARMOR) {
+        else if (item->getType() == ItemType::ARMOR) {
             if (equippedArmor) {
                 // Unequip current armor
-                stats.modifyDefense(-equippedArmor->defenseBonus);
-                cout << "Unequipped " << equippedArmor->name << endl;
+                stats.modifyDefense(-equippedArmor->getDefenseBonus());
+                cout << "Unequipped " << equippedArmor->getName() << endl;
             }
 
             equippedArmor = item;
-            stats.modifyDefense(item->defenseBonus);
-            cout << "Equipped " << item->name << " (+" << item->defenseBonus << " DEF)" << endl;
+            stats.modifyDefense(item->getDefenseBonus());
+            cout << "Equipped " << item->getName() << " (+" << item->getDefenseBonus() << " DEF)" << endl;
         }
     }
 
     void unequipWeapon() {
         if (equippedWeapon) {
-            stats.modifyStrength(-equippedWeapon->attackBonus);
-            cout << "Unequipped " << equippedWeapon->name << endl;
+            stats.modifyStrength(-equippedWeapon->getAttackBonus());
+            cout << "Unequipped " << equippedWeapon->getName() << endl;
             equippedWeapon = nullptr;
         }
     }
 
     void unequipArmor() {
         if (equippedArmor) {
-            stats.modifyDefense(-equippedArmor->defenseBonus);
-            cout << "Unequipped " << equippedArmor->name << endl;
+            stats.modifyDefense(-equippedArmor->getDefenseBonus());
+            cout << "Unequipped " << equippedArmor->getName() << endl;
             equippedArmor = nullptr;
         }
     }
@@ -131,15 +131,15 @@ public:
 
         cout << "\nEquipped:" << endl;
         if (equippedWeapon) {
-            cout << "  Weapon: " << equippedWeapon->name
-                     << " (+" << equippedWeapon->attackBonus << " ATK)" << endl;
+            cout << "  Weapon: " << equippedWeapon->getName()
+                     << " (+" << equippedWeapon->getAttackBonus() << " ATK)" << endl;
         } else {
             cout << "  Weapon: None" << endl;
         }
 
         if (equippedArmor) {
-            cout << "  Armor: " << equippedArmor->name
-                     << " (+" << equippedArmor->defenseBonus << " DEF)" << endl;
+            cout << "  Armor: " << equippedArmor->getName()
+                     << " (+" << equippedArmor->getDefenseBonus() << " DEF)" << endl;
         } else {
             cout << "  Armor: None" << endl;
         }
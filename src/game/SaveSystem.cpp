@@ -38,15 +38,15 @@ bool SaveSystem::saveGame(const Player& player, const string& currentNodeId, con
     auto itemEnd = itemIt.end();
     while (itemIt != itemEnd) {
         const Item& item = itemIt.getCurrent()->getValue();
-        writeString(file, item.name);
-        writeString(file, item.description);
-        writeInt(file, static_cast<int>(item.type));
-        writeInt(file, item.value);
-        writeInt(file, item.weight);
-        writeInt(file, item.healthRestore);
-        writeInt(file, item.manaRestore);
-        writeInt(file, item.attackBonus);
-        writeInt(file, item.defenseBonus);
+        writeString(file, item.getName());
+        writeString(file, item.getDescription());
+        writeInt(file, static_cast<int>(item.getType()));
+        writeInt(file, item.getValue());
+        writeInt(file, item.getWeight());
+        writeInt(file, item.getHealthRestore());
+        writeInt(file, item.getManaRestore());
+        writeInt(file, item.getAttackBonus());
+        writeInt(file, item.getDefenseBonus());
         ++itemIt;
     }
 
@@ -95,19 +95,21 @@ bool SaveSystem::loadGame(Player& player, string& currentNodeId, const string& f
     player.getInventory().clear(); // Clear existing items before loading
     player.getInventory().setGold(gold);
 
-    // Load inventory items and add to player's inventory
+    // Load inventory items and add to player's inventory. Saved items share
+    // prototypes with the ones dialogue actions hand out.
     int itemCount = readInt(file);
     for (int i = 0; i < itemCount; ++i) {
-        Item item;
-        item.name = readString(file);
-        item.description = readString(file);
-        item.type = static_cast<ItemType>(readInt(file));
-        item.value = readInt(file);
-        item.weight = readInt(file);
-        item.healthRestore = readInt(file);
-        item.manaRestore = readInt(file);
-        item.attackBonus = readInt(file);
-        item.defenseBonus = readInt(file);
+        ItemPrototype definition;
+        definition.name = readString(file);
+        definition.description = readString(file);
+        definition.type = static_cast<ItemType>(readInt(file));
+        int value = readInt(file);
+        definition.weight = readInt(file);
+        definition.healthRestore = readInt(file);
+        definition.manaRestore = readInt(file);
+        definition.attackBonus = readInt(file);
+        definition.defenseBonus = readInt(file);
+        Item item(ItemRegistry::global().intern(definition), value);
         player.getInventory().addItem(item); // Add to inventory list
     }
 
@@ -0,0 +1,21 @@
+#include "StoryTimelines.h"
+#include "game/Player.h"
+
+namespace {
+// Challenging the critic's voice: it keeps draining focus, once after a pause
+// and again at the player's next action, until they reach the sectors
+Timeline criticEcho(TimelineScheduler& timelines, Player& player) {
+    co_await timelines.delay(4.0f);
+    player.getStats().restoreMana(-3);
+
+    co_await timelines.waitForInput();
+    player.getStats().restoreMana(-2);
+
+    co_await timelines.waitForNode("choose_sector");
+    player.getStats().restoreMana(5);
+}
+}
+
+void registerStoryTimelines(TimelineRegistry& registry) {
+    registry.add("critic_echo", criticEcho);
+}
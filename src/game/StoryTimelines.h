@@ -0,0 +1,7 @@
+#pragma once
+
+#include "dialogue/Timeline.h"
+
+// Register the story's scripted timelines (started by "timeline:<name>"
+// choice effects in assets/dialogues) with registry
+void registerStoryTimelines(TimelineRegistry& registry);
@@ -0,0 +1,543 @@
+// Dialogue graph analyzer: static checks over a whole script set, without the game.
+// Usage: dialogue_analyzer [--dot graph.dot] [--json report.json] [--threads N]
+//                          (--dir <directory> | --manifest <file> | <script.txt>...)
+// Reports nodes the root cannot reach, choices whose target: does not exist,
+// dead ends (nodes without choices), cycles (strongly connected components,
+// flagged when no choice leaves them), conditions no player can satisfy, and
+// choice fan-out. Exits with 2 when dangling targets or unsatisfiable
+// conditions are found, 1 when the scripts cannot be loaded.
+#include "dialogue/DialogueGraph.h"
+#include "game/Player.h"
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <thread>
+
+using namespace std;
+
+namespace {
+    constexpr int REPORT_LIMIT = 20;       // Entries printed per finding; the JSON report has all of them
+    constexpr int FAN_OUT_BUCKETS = 7;     // 0, 1, 2, 3, 4, 5-8, 9+
+
+    struct ChoiceRef {
+        int node;
+        int choice;
+    };
+
+    // Results of the per-node pass over one slice of the graph
+    struct SliceResult {
+        ArrayList<int> deadEnds;
+        ArrayList<ChoiceRef> dangling;
+        ArrayList<ChoiceRef> unsatisfiable;
+        int fanOutHistogram[FAN_OUT_BUCKETS] = {};
+    };
+
+    struct Component {
+        ArrayList<int> members;
+        bool closed;          // No choice leaves the component or ends the dialogue
+    };
+
+    // Compiled graph in compressed sparse row form: the choices of node i are
+    // firstChoice[i] .. firstChoice[i + 1] - 1; targets are node indices or NO_TARGET
+    struct Graph {
+        int nodeCount = 0;
+        ArrayList<int> firstChoice;
+        ArrayList<int> targets;
+    };
+
+    int fanOutBucket(int choices) {
+        if (choices <= 4) return choices;
+        return choices <= 8 ? 5 : 6;
+    }
+
+    const char* const BUCKET_NAMES[FAN_OUT_BUCKETS] = {"0", "1", "2", "3", "4", "5-8", "9+"};
+
+    Graph copyGraph(const DialogueGraph& dialogue) {
+        Graph graph;
+        graph.nodeCount = dialogue.getNodeCount();
+        graph.firstChoice.reserve(graph.nodeCount + 1);
+        for (int node = 0; node < graph.nodeCount; ++node) {
+            graph.firstChoice.push(graph.targets.length());
+            for (int choice = 0; choice < dialogue.getChoiceCount(node); ++choice) {
+                graph.targets.push(dialogue.getTarget(node, choice));
+            }
+        }
+        graph.firstChoice.push(graph.targets.length());
+        return graph;
+    }
+
+    // Breadth-first search from the root
+    ArrayList<bool> findReachable(const Graph& graph, int root) {
+        ArrayList<bool> reached;
+        reached.reserve(graph.nodeCount);
+        for (int node = 0; node < graph.nodeCount; ++node) {
+            reached.push(false);
+        }
+        if (root < 0) {
+            return reached;
+        }
+
+        ArrayList<int> frontier;
+        frontier.push(root);
+        reached[root] = true;
+        for (int head = 0; head < frontier.length(); ++head) {
+            int node = frontier[head];
+            for (int i = graph.firstChoice[node]; i < graph.firstChoice[node + 1]; ++i) {
+                int target = graph.targets[i];
+                if (target >= 0 && !reached[target]) {
+                    reached[target] = true;
+                    frontier.push(target);
+                }
+            }
+        }
+        return reached;
+    }
+
+    // Tarjan's algorithm with an explicit stack (script graphs are deep enough to
+    // overflow the call stack). Keeps components with a cycle: more than one
+    // node, or a node with a choice back to itself.
+    ArrayList<Component> findCycles(const Graph& graph) {
+        constexpr int UNVISITED = -1;
+        ArrayList<int> order, lowLink, componentOf;
+        ArrayList<bool> onStack;
+        order.reserve(graph.nodeCount);
+        lowLink.reserve(graph.nodeCount);
+        componentOf.reserve(graph.nodeCount);
+        onStack.reserve(graph.nodeCount);
+        for (int node = 0; node < graph.nodeCount; ++node) {
+            order.push(UNVISITED);
+            lowLink.push(0);
+            componentOf.push(UNVISITED);
+            onStack.push(false);
+        }
+
+        struct Frame {
+            int node;
+            int nextChoice;
+        };
+        ArrayList<Frame> callStack;
+        ArrayList<int> sccStack;
+        ArrayList<Component> cycles;
+        int counter = 0;
+        int componentCount = 0;
+
+        for (int start = 0; start < graph.nodeCount; ++start) {
+            if (order[start] != UNVISITED) {
+                continue;
+            }
+            callStack.push(Frame{start, graph.firstChoice[start]});
+            order[start] = lowLink[start] = counter++;
+            sccStack.push(start);
+            onStack[start] = true;
+
+            while (!callStack.isEmpty()) {
+                Frame& frame = callStack.getLast();
+                int node = frame.node;
+                if (frame.nextChoice < graph.firstChoice[node + 1]) {
+                    int target = graph.targets[frame.nextChoice++];
+                    if (target < 0) {
+                        continue;
+                    }
+                    if (order[target] == UNVISITED) {
+                        order[target] = lowLink[target] = counter++;
+                        sccStack.push(target);
+                        onStack[target] = true;
+                        callStack.push(Frame{target, graph.firstChoice[target]});
+                    } else if (onStack[target]) {
+                        lowLink[node] = min(lowLink[node], order[target]);
+                    }
+                    continue;
+                }
+
+                // All choices visited: pop, and close a component at its root
+                callStack.pop();
+                if (!callStack.isEmpty()) {
+                    int parent = callStack.getLast().node;
+                    lowLink[parent] = min(lowLink[parent], lowLink[node]);
+                }
+                if (lowLink[node] != order[node]) {
+                    continue;
+                }
+
+                Component component;
+                int member;
+                do {
+                    member = sccStack.pop();
+                    onStack[member] = false;
+                    componentOf[member] = componentCount;
+                    component.members.push(member);
+                } while (member != node);
+
+                bool cyclic = component.members.length() > 1;
+                bool closed = true;
+                for (int m : component.members) {
+                    closed = closed && graph.firstChoice[m] < graph.firstChoice[m + 1];   // A dead end ends the dialogue
+                    for (int i = graph.firstChoice[m]; i < graph.firstChoice[m + 1]; ++i) {
+                        int target = graph.targets[i];
+                        cyclic = cyclic || target == m;
+                        closed = closed && target >= 0 && componentOf[target] == componentCount;
+                    }
+                }
+                ++componentCount;
+                if (cyclic) {
+                    sort(component.members.getData(), component.members.getData() + component.members.length());
+                    component.closed = closed;
+                    cycles.push(std::move(component));
+                }
+            }
+        }
+        return cycles;
+    }
+
+    void analyzeSlice(const DialogueGraph& dialogue, const Graph& graph, int begin, int end, SliceResult& result) {
+        for (int node = begin; node < end; ++node) {
+            int choices = graph.firstChoice[node + 1] - graph.firstChoice[node];
+            result.fanOutHistogram[fanOutBucket(choices)]++;
+            if (choices == 0) {
+                result.deadEnds.push(node);
+            }
+            for (int choice = 0; choice < choices; ++choice) {
+                if (graph.targets[graph.firstChoice[node] + choice] == DialogueGraph::NO_TARGET &&
+                    !dialogue.getTargetId(node, choice).empty()) {
+                    result.dangling.push(ChoiceRef{node, choice});
+                }
+                const ConditionProgram* condition = dialogue.getCondition(node, choice);
+                if (condition && !condition->isSatisfiable()) {
+                    result.unsatisfiable.push(ChoiceRef{node, choice});
+                }
+            }
+        }
+    }
+
+    // "file:line: " for a node defined in a script, empty for image-backed graphs
+    string locationOf(const DialogueGraph& dialogue, int node) {
+        const NodeLocation* location = dialogue.getNodeLocation(dialogue.getNodeId(node));
+        if (!location) {
+            return "";
+        }
+        return dialogue.getFileName(location->fileIndex) + ":" + to_string(location->line) + ": ";
+    }
+
+    void printOmitted(int total) {
+        if (total > REPORT_LIMIT) {
+            cout << "  ... and " << total - REPORT_LIMIT << " more" << endl;
+        }
+    }
+
+    // Escapes for both output formats: quotes, backslashes and control characters
+    string escapeString(string_view text) {
+        string escaped;
+        escaped.reserve(text.size());
+        for (char c : text) {
+            switch (c) {
+                case '"': escaped += "\\\""; break;
+                case '\\': escaped += "\\\\"; break;
+                case '\n': escaped += "\\n"; break;
+                case '\r': escaped += "\\r"; break;
+                case '\t': escaped += "\\t"; break;
+                default:
+                    if (static_cast<unsigned char>(c) < 0x20) {
+                        const char* hex = "0123456789abcdef";
+                        escaped += "\\u00";
+                        escaped += hex[(c >> 4) & 0xF];
+                        escaped += hex[c & 0xF];
+                    } else {
+                        escaped += c;
+                    }
+            }
+        }
+        return escaped;
+    }
+
+    bool writeDot(const string& path, const DialogueGraph& dialogue, const Graph& graph,
+                  const ArrayList<bool>& reachable) {
+        ofstream out(path);
+        if (!out) {
+            cerr << "Cannot write " << path << endl;
+            return false;
+        }
+
+        out << "digraph dialogue {\n  node [shape=box];\n";
+        for (int node = 0; node < graph.nodeCount; ++node) {
+            out << "  n" << node << " [label=\"" << escapeString(dialogue.getNodeId(node)) << "\"";
+            if (node == dialogue.getRootNode()) {
+                out << ", penwidth=2";
+            }
+            if (!reachable[node]) {
+                out << ", style=dashed, color=gray";
+            }
+            if (graph.firstChoice[node] == graph.firstChoice[node + 1]) {
+                out << ", shape=octagon";
+            }
+            out << "];\n";
+        }
+
+        bool anyDangling = false;
+        for (int node = 0; node < graph.nodeCount; ++node) {
+            for (int choice = 0; choice < dialogue.getChoiceCount(node); ++choice) {
+                int target = graph.targets[graph.firstChoice[node] + choice];
+                string label = escapeString(dialogue.getChoiceText(node, choice));
+                if (target >= 0) {
+                    out << "  n" << node << " -> n" << target << " [label=\"" << label << "\"];\n";
+                } else if (!dialogue.getTargetId(node, choice).empty()) {
+                    anyDangling = true;
+                    out << "  n" << node << " -> missing [label=\"" << label << " ("
+                        << escapeString(dialogue.getTargetId(node, choice)) << ")\", color=red];\n";
+                }
+            }
+        }
+        if (anyDangling) {
+            out << "  missing [label=\"missing target\", shape=none, fontcolor=red];\n";
+        }
+        out << "}\n";
+        return static_cast<bool>(out);
+    }
+
+    void writeChoiceList(ofstream& out, const DialogueGraph& dialogue, const ArrayList<ChoiceRef>& choices, bool withTarget) {
+        for (int i = 0; i < choices.length(); ++i) {
+            const ChoiceRef& ref = choices[i];
+            out << (i ? ",\n    " : "\n    ") << "{\"node\": \"" << escapeString(dialogue.getNodeId(ref.node))
+                << "\", \"choice\": " << ref.choice
+                << ", \"text\": \"" << escapeString(dialogue.getChoiceText(ref.node, ref.choice)) << "\"";
+            if (withTarget) {
+                out << ", \"target\": \"" << escapeString(dialogue.getTargetId(ref.node, ref.choice)) << "\"";
+            } else {
+                out << ", \"condition\": \"" << escapeString(dialogue.getCondition(ref.node, ref.choice)->getSource()) << "\"";
+            }
+            const NodeLocation* location = dialogue.getNodeLocation(dialogue.getNodeId(ref.node));
+            if (location) {
+                out << ", \"file\": \"" << escapeString(dialogue.getFileName(location->fileIndex))
+                    << "\", \"line\": " << location->line;
+            }
+            out << "}";
+        }
+        out << (choices.isEmpty() ? "]" : "\n  ]");
+    }
+
+    void writeNodeList(ofstream& out, const DialogueGraph& dialogue, const ArrayList<int>& nodes) {
+        out << "[";
+        for (int i = 0; i < nodes.length(); ++i) {
+            out << (i ? ", " : "") << "\"" << escapeString(dialogue.getNodeId(nodes[i])) << "\"";
+        }
+        out << "]";
+    }
+
+    bool writeJson(const string& path, const DialogueGraph& dialogue, const Graph& graph,
+                   const ArrayList<bool>& reachable, const ArrayList<int>& unreachable,
+                   const SliceResult& totals, const ArrayList<Component>& cycles) {
+        ofstream out(path);
+        if (!out) {
+            cerr << "Cannot write " << path << endl;
+            return false;
+        }
+
+        int root = dialogue.getRootNode();
+        out << "{\n  \"nodeCount\": " << graph.nodeCount
+            << ",\n  \"choiceCount\": " << graph.targets.length()
+            << ",\n  \"root\": " << (root >= 0 ? "\"" + escapeString(dialogue.getNodeId(root)) + "\"" : "null");
+
+        out << ",\n  \"unreachable\": ";
+        writeNodeList(out, dialogue, unreachable);
+        out << ",\n  \"deadEnds\": ";
+        writeNodeList(out, dialogue, totals.deadEnds);
+        out << ",\n  \"danglingTargets\": [";
+        writeChoiceList(out, dialogue, totals.dangling, true);
+        out << ",\n  \"unsatisfiableConditions\": [";
+        writeChoiceList(out, dialogue, totals.unsatisfiable, false);
+
+        out << ",\n  \"cycles\": [";
+        for (int i = 0; i < cycles.length(); ++i) {
+            out << (i ? ",\n    " : "\n    ") << "{\"closed\": " << (cycles[i].closed ? "true" : "false") << ", \"nodes\": ";
+            writeNodeList(out, dialogue, cycles[i].members);
+            out << "}";
+        }
+        out << (cycles.isEmpty() ? "]" : "\n  ]");
+
+        out << ",\n  \"fanOutHistogram\": {";
+        for (int bucket = 0; bucket < FAN_OUT_BUCKETS; ++bucket) {
+            out << (bucket ? ", " : "") << "\"" << BUCKET_NAMES[bucket] << "\": " << totals.fanOutHistogram[bucket];
+        }
+        out << "}";
+
+        out << ",\n  \"nodes\": [";
+        for (int node = 0; node < graph.nodeCount; ++node) {
+            out << (node ? ",\n    " : "\n    ") << "{\"id\": \"" << escapeString(dialogue.getNodeId(node))
+                << "\", \"fanOut\": " << graph.firstChoice[node + 1] - graph.firstChoice[node]
+                << ", \"reachable\": " << (reachable[node] ? "true" : "false") << "}";
+        }
+        out << (graph.nodeCount ? "\n  ]\n}\n" : "]\n}\n");
+        return static_cast<bool>(out);
+    }
+
+    int usage() {
+        cerr << "Usage: dialogue_analyzer [--dot graph.dot] [--json report.json] [--threads N]\n"
+                "                         (--dir <directory> | --manifest <file> | <script.txt>...)" << endl;
+        return 1;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    string dotFile, jsonFile, directory, manifest;
+    List<string> scripts;
+    int threadCount = static_cast<int>(thread::hardware_concurrency());
+
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--dot" && hasValue) {
+            dotFile = argv[++i];
+        } else if (arg == "--json" && hasValue) {
+            jsonFile = argv[++i];
+        } else if (arg == "--threads" && hasValue) {
+            threadCount = stoi(argv[++i]);
+        } else if (arg == "--dir" && hasValue) {
+            directory = argv[++i];
+        } else if (arg == "--manifest" && hasValue) {
+            manifest = argv[++i];
+        } else if (arg.starts_with("--")) {
+            return usage();
+        } else {
+            scripts.push(arg);
+        }
+    }
+    int sources = !directory.empty() + !manifest.empty() + !scripts.isEmpty();
+    if (sources != 1) {
+        return usage();
+    }
+    threadCount = max(threadCount, 1);
+
+    auto start = chrono::steady_clock::now();
+    Player player;
+    DialogueGraph dialogue(player);
+    bool loaded = !directory.empty() ? dialogue.loadDirectory(directory)
+                : !manifest.empty() ? dialogue.loadManifest(manifest)
+                : dialogue.loadFiles(scripts);
+    if (!loaded) {
+        return 1;
+    }
+    dialogue.compileAll();
+    Graph graph = copyGraph(dialogue);
+    auto loadedAt = chrono::steady_clock::now();
+
+    // The whole-graph passes run on their own threads while the per-node pass is
+    // split across the rest; everything only reads the compiled graph
+    ArrayList<bool> reachable;
+    ArrayList<Component> cycles;
+    thread reachabilityPass([&] { reachable = findReachable(graph, dialogue.getRootNode()); });
+    thread cyclePass([&] { cycles = findCycles(graph); });
+
+    int sliceCount = max(threadCount - 2, 1);
+    ArrayList<SliceResult> slices;
+    for (int i = 0; i < sliceCount; ++i) {
+        slices.emplace();
+    }
+    ArrayList<thread> workers;
+    for (int i = 0; i < sliceCount; ++i) {
+        int begin = static_cast<int>(static_cast<int64_t>(graph.nodeCount) * i / sliceCount);
+        int end = static_cast<int>(static_cast<int64_t>(graph.nodeCount) * (i + 1) / sliceCount);
+        workers.emplace([&, i, begin, end] { analyzeSlice(dialogue, graph, begin, end, slices[i]); });
+    }
+    for (thread& worker : workers) {
+        worker.join();
+    }
+    reachabilityPass.join();
+    cyclePass.join();
+
+    // Slices cover the nodes in order, so merged findings are in node order
+    SliceResult totals;
+    for (const SliceResult& slice : slices) {
+        for (int node : slice.deadEnds) totals.deadEnds.push(node);
+        for (const ChoiceRef& ref : slice.dangling) totals.dangling.push(ref);
+        for (const ChoiceRef& ref : slice.unsatisfiable) totals.unsatisfiable.push(ref);
+        for (int bucket = 0; bucket < FAN_OUT_BUCKETS; ++bucket) {
+            totals.fanOutHistogram[bucket] += slice.fanOutHistogram[bucket];
+        }
+    }
+    ArrayList<int> unreachable;
+    int maxFanOut = 0, widestNode = -1;
+    for (int node = 0; node < graph.nodeCount; ++node) {
+        if (!reachable[node]) {
+            unreachable.push(node);
+        }
+        int fanOut = graph.firstChoice[node + 1] - graph.firstChoice[node];
+        if (fanOut > maxFanOut) {
+            maxFanOut = fanOut;
+            widestNode = node;
+        }
+    }
+    int closedCycles = 0;
+    for (const Component& cycle : cycles) {
+        closedCycles += cycle.closed;
+    }
+    auto analyzedAt = chrono::steady_clock::now();
+
+    // Text report
+    int root = dialogue.getRootNode();
+    cout << graph.nodeCount << " nodes, " << graph.targets.length() << " choices, root "
+         << (root >= 0 ? "'" + string(dialogue.getNodeId(root)) + "'" : string("missing")) << endl;
+
+    cout << unreachable.length() << " unreachable node(s)" << endl;
+    for (int i = 0; i < min(unreachable.length(), REPORT_LIMIT); ++i) {
+        cout << "  " << locationOf(dialogue, unreachable[i]) << dialogue.getNodeId(unreachable[i]) << endl;
+    }
+    printOmitted(unreachable.length());
+
+    cout << totals.dangling.length() << " dangling target(s)" << endl;
+    for (int i = 0; i < min(totals.dangling.length(), REPORT_LIMIT); ++i) {
+        const ChoiceRef& ref = totals.dangling[i];
+        cout << "  " << locationOf(dialogue, ref.node) << "node '" << dialogue.getNodeId(ref.node)
+             << "' choice " << ref.choice + 1 << " targets missing node '"
+             << dialogue.getTargetId(ref.node, ref.choice) << "'" << endl;
+    }
+    printOmitted(totals.dangling.length());
+
+    cout << totals.deadEnds.length() << " dead end(s)" << endl;
+    for (int i = 0; i < min(totals.deadEnds.length(), REPORT_LIMIT); ++i) {
+        cout << "  " << locationOf(dialogue, totals.deadEnds[i]) << dialogue.getNodeId(totals.deadEnds[i]) << endl;
+    }
+    printOmitted(totals.deadEnds.length());
+
+    cout << cycles.length() << " cycle(s), " << closedCycles << " with no way out" << endl;
+    for (int i = 0; i < min(cycles.length(), REPORT_LIMIT); ++i) {
+        const Component& cycle = cycles[i];
+        cout << "  " << cycle.members.length() << " node(s)" << (cycle.closed ? ", no way out" : "") << ":";
+        for (int m = 0; m < min(cycle.members.length(), 8); ++m) {
+            cout << " " << dialogue.getNodeId(cycle.members[m]);
+        }
+        cout << (cycle.members.length() > 8 ? " ..." : "") << endl;
+    }
+    printOmitted(cycles.length());
+
+    cout << totals.unsatisfiable.length() << " unsatisfiable condition(s)" << endl;
+    for (int i = 0; i < min(totals.unsatisfiable.length(), REPORT_LIMIT); ++i) {
+        const ChoiceRef& ref = totals.unsatisfiable[i];
+        cout << "  " << locationOf(dialogue, ref.node) << "node '" << dialogue.getNodeId(ref.node)
+             << "' choice " << ref.choice + 1 << ": if: "
+             << dialogue.getCondition(ref.node, ref.choice)->getSource() << endl;
+    }
+    printOmitted(totals.unsatisfiable.length());
+
+    cout << "Fan-out:";
+    for (int bucket = 0; bucket < FAN_OUT_BUCKETS; ++bucket) {
+        cout << " " << BUCKET_NAMES[bucket] << ":" << totals.fanOutHistogram[bucket];
+    }
+    if (widestNode >= 0) {
+        cout << " (max " << maxFanOut << " at '" << dialogue.getNodeId(widestNode) << "')";
+    }
+    cout << endl;
+
+    if (!dotFile.empty() && !writeDot(dotFile, dialogue, graph, reachable)) {
+        return 1;
+    }
+    if (!jsonFile.empty() && !writeJson(jsonFile, dialogue, graph, reachable, unreachable, totals, cycles)) {
+        return 1;
+    }
+
+    auto milliseconds = [](auto from, auto to) { return chrono::duration<double, milli>(to - from).count(); };
+    cout << "Loaded in " << milliseconds(start, loadedAt) << " ms, analyzed in "
+         << milliseconds(loadedAt, analyzedAt) << " ms (" << threadCount << " threads)" << endl;
+
+    return totals.dangling.isEmpty() && totals.unsatisfiable.isEmpty() ? 0 : 2;
+}
@@ -0,0 +1,41 @@
+// Dialogue script compiler: turns scripts into a binary image (see DialogueImage.h).
+// Usage: dialogue_compiler <output.dlgc> <script.txt> [more scripts...]
+// Scripts are loaded in the given order, with the same precedence as
+// loadFromFile followed by loadAdditionalFile.
+#include "dialogue/DialogueGraph.h"
+#include "game/Player.h"
+#include <iostream>
+#include <string>
+
+using namespace std;
+
+int main(int argc, char* argv[]) {
+    if (argc < 3) {
+        cerr << "Usage: dialogue_compiler <output.dlgc> <script.txt> [more scripts...]" << endl;
+        return 1;
+    }
+
+    string output = argv[1];
+    List<string> scripts;
+    for (int i = 2; i < argc; ++i) {
+        scripts.push(argv[i]);
+    }
+
+    uint64_t sourceHash = 0;
+    if (!DialogueImage::hashSources(scripts, sourceHash)) {
+        cerr << "Cannot read dialogue scripts" << endl;
+        return 1;
+    }
+
+    Player player;
+    DialogueGraph graph(player);
+    if (!graph.loadFiles(scripts)) {
+        return 1;
+    }
+
+    if (!graph.saveImage(output, sourceHash)) {
+        return 1;
+    }
+    cout << "Compiled " << graph.getNodeCount() << " nodes into " << output << endl;
+    return 0;
+}
@@ -0,0 +1,70 @@
+// Dialogue script parse throughput benchmark.
+// Usage: parse_benchmark <script.txt> [more scripts...] [-n iterations]
+// Loads the scripts through DialogueGraph repeatedly and reports MB/s.
+#include "dialogue/DialogueGraph.h"
+#include "game/Player.h"
+#include <chrono>
+#include <filesystem>
+#include <iostream>
+#include <string>
+
+using namespace std;
+
+int main(int argc, char* argv[]) {
+    List<string> scripts;
+    int iterations = 20;
+
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        if (arg == "-n" && i + 1 < argc) {
+            iterations = stoi(argv[++i]);
+        } else {
+            scripts.push(arg);
+        }
+    }
+
+    if (scripts.isEmpty() || iterations <= 0) {
+        cerr << "Usage: parse_benchmark <script.txt> [more scripts...] [-n iterations]" << endl;
+        return 1;
+    }
+
+    uintmax_t bytesPerPass = 0;
+    for (const string& script : scripts) {
+        error_code error;
+        bytesPerPass += filesystem::file_size(script, error);
+        if (error) {
+            cerr << "Cannot read " << script << ": " << error.message() << endl;
+            return 1;
+        }
+    }
+
+    Player player;
+    double bestSeconds = 0.0;
+    double totalSeconds = 0.0;
+
+    for (int pass = 0; pass < iterations; ++pass) {
+        DialogueGraph graph(player);
+
+        auto start = chrono::steady_clock::now();
+        bool first = true;
+        for (const string& script : scripts) {
+            bool loaded = first ? graph.loadFromFile(script) : graph.loadAdditionalFile(script);
+            if (!loaded) {
+                return 1;
+            }
+            first = false;
+        }
+        double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+        totalSeconds += seconds;
+        if (pass == 0 || seconds < bestSeconds) {
+            bestSeconds = seconds;
+        }
+    }
+
+    double megabytes = static_cast<double>(bytesPerPass) / (1024.0 * 1024.0);
+    cout << "Parsed " << megabytes << " MB x " << iterations << " passes" << endl;
+    cout << "  mean: " << (megabytes * iterations / totalSeconds) << " MB/s" << endl;
+    cout << "  best: " << (megabytes / bestSeconds) << " MB/s" << endl;
+    return 0;
+}